@@ -0,0 +1,294 @@
+#include "BenchmarkReport.h"
+#include "../include/KVStore.h"
+
+#include <nlohmann/json.hpp>
+
+#include <cstdio>
+#include <ctime>
+#include <cmath>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <filesystem>
+#include <vector>
+
+using json = nlohmann::json;
+
+#ifdef _WIN32
+#define popen _popen
+#define pclose _pclose
+static constexpr const char* GIT_REVISION_COMMAND = "git rev-parse --short HEAD 2>nul";
+#else
+static constexpr const char* GIT_REVISION_COMMAND = "git rev-parse --short HEAD 2>/dev/null";
+#endif
+
+std::string gitRevision() {
+
+    FILE* pipe = popen(GIT_REVISION_COMMAND, "r");
+    if (!pipe)
+        return "unknown";
+
+    char buf[64] = {0};
+    std::string rev;
+
+    if (fgets(buf, sizeof(buf), pipe))
+        rev = buf;
+
+    pclose(pipe);
+
+    while (!rev.empty() && (rev.back() == '\n' || rev.back() == '\r'))
+        rev.pop_back();
+
+    return rev.empty() ? "unknown" : rev;
+}
+
+static std::string timestamp(const char* format) {
+
+    std::time_t now = std::time(nullptr);
+    std::tm tm{};
+
+#ifdef _WIN32
+    localtime_s(&tm, &now);
+#else
+    localtime_r(&now, &tm);
+#endif
+
+    char buf[32];
+    std::strftime(buf, sizeof(buf), format, &tm);
+    return buf;
+}
+
+std::string defaultResultPath(const BenchmarkConfig& config,
+                              const std::string& strategy) {
+
+    return "benchmark_results/raw/" + strategy + "_" +
+           workloadName(config.workload) + "_" +
+           std::to_string(config.total_ops) + "_" +
+           timestamp("%Y%m%d_%H%M%S") + ".json";
+}
+
+static json latencyJson(const HistogramSnapshot& h) {
+
+    auto us = [](uint64_t ns) { return ns / 1000.0; };
+
+    return {
+        {"count", h.count},
+        {"mean", h.mean() / 1000.0},
+        {"p50", us(h.percentile(50))},
+        {"p90", us(h.percentile(90))},
+        {"p99", us(h.percentile(99))},
+        {"p99_9", us(h.percentile(99.9))},
+        {"max", us(h.max)}
+    };
+}
+
+bool writeResultJson(const std::string& path,
+                     const BenchmarkConfig& config,
+                     const RunnerOptions& options,
+                     const std::string& strategy,
+                     const RunResult& result,
+                     const KVStore& db) {
+
+    const Statistics& stats = db.getStatistics();
+
+    json latency;
+    for (size_t t = 0; t < OPERATION_TYPE_COUNT; t++) {
+        if (result.latency[t].count)
+            latency[operationName(static_cast<OperationType>(t))] =
+                latencyJson(result.latency[t]);
+    }
+    latency["ALL"] = latencyJson(result.overall);
+
+    json levels = json::array();
+    for (const LevelStats& l : db.getLevelStats()) {
+        levels.push_back({
+            {"level", l.level},
+            {"files", l.files},
+            {"live_bytes", l.liveBytes},
+            {"flush_bytes", l.flushBytes},
+            {"compaction_read_upper_bytes", l.compactionReadUpper},
+            {"compaction_read_lower_bytes", l.compactionReadLower},
+            {"compaction_written_bytes", l.compactionWritten},
+            {"compactions", l.compactions},
+            {"write_amp", l.writeAmp},
+            {"get_tables_read", l.getTablesRead},
+            {"get_bytes_read", l.getBytesRead}
+        });
+    }
+
+    const uint64_t hits = stats.getTickerCount(Ticker::CACHE_HITS);
+    const uint64_t lookups = hits + stats.getTickerCount(Ticker::CACHE_MISSES);
+
+    json record = {
+        {"format_version", 1},
+        {"timestamp", timestamp("%Y-%m-%dT%H:%M:%S")},
+        {"git_revision", gitRevision()},
+        {"config", {
+            {"workload", workloadName(config.workload)},
+            {"key_dist", keyDistributionName(config.key_dist)},
+            {"total_ops", config.total_ops},
+            {"key_space", config.key_space},
+            {"value_size", config.value_size},
+            {"value_size_min", config.value_size_min},
+            {"value_dist", valueSizeDistributionName(config.value_dist)},
+            {"zipf_theta", config.zipf_theta},
+            {"seed", config.seed},
+            {"threads", result.threads},
+            {"target_ops_per_sec", options.target_ops_per_sec},
+            {"strategy", strategy}
+        }},
+        {"seconds", result.seconds},
+        {"total_ops", result.total_ops},
+        {"throughput_ops_per_sec", result.throughput()},
+        {"latency_us", latency},
+        {"amplification", {
+            {"write", db.writeAmplification()},
+            {"read", db.readAmplification()},
+            {"space", db.spaceAmplification()}
+        }},
+        {"levels", levels},
+        {"cache", {
+            {"hits", hits},
+            {"misses", lookups - hits},
+            {"hit_rate", lookups ? static_cast<double>(hits) / lookups : 0.0}
+        }},
+        {"bloom", {
+            {"checks", stats.getTickerCount(Ticker::BLOOM_CHECKS)},
+            {"negatives", stats.getTickerCount(Ticker::BLOOM_NEGATIVES)},
+            {"false_positives", stats.getTickerCount(Ticker::BLOOM_FALSE_POSITIVES)}
+        }}
+    };
+
+    std::error_code ec;
+    const auto parent = std::filesystem::path(path).parent_path();
+    if (!parent.empty())
+        std::filesystem::create_directories(parent, ec);
+
+    std::ofstream out(path, std::ios::trunc);
+    if (!out.is_open()) {
+        std::cerr << "Failed to write benchmark result: " << path << "\n";
+        return false;
+    }
+
+    out << record.dump(2) << "\n";
+    return true;
+}
+
+// =======================
+// COMPARE
+// =======================
+static bool loadJson(const std::string& path, json& out) {
+
+    std::ifstream in(path);
+    if (!in.is_open()) {
+        std::cerr << "Failed to open " << path << "\n";
+        return false;
+    }
+
+    out = json::parse(in, nullptr, false);
+    if (out.is_discarded()) {
+        std::cerr << "Invalid JSON in " << path << "\n";
+        return false;
+    }
+
+    return true;
+}
+
+// Looks up a value by "/"-separated path; false if absent
+static bool metric(const json& record, const std::string& path, double& value) {
+
+    const json* node = &record;
+    size_t pos = 0;
+
+    while (pos <= path.size()) {
+        size_t slash = path.find('/', pos);
+        if (slash == std::string::npos) slash = path.size();
+
+        const std::string part = path.substr(pos, slash - pos);
+        if (!node->is_object() || !node->contains(part))
+            return false;
+
+        node = &(*node)[part];
+        pos = slash + 1;
+    }
+
+    if (!node->is_number())
+        return false;
+
+    value = node->get<double>();
+    return true;
+}
+
+int compareResults(const std::string& baselinePath,
+                   const std::string& candidatePath,
+                   double thresholdPercent) {
+
+    json base, cand;
+    if (!loadJson(baselinePath, base) || !loadJson(candidatePath, cand))
+        return -1;
+
+    // Metric path and whether a larger value is better
+    std::vector<std::pair<std::string, bool>> metrics = {
+        {"throughput_ops_per_sec", true},
+        {"amplification/write", false},
+        {"amplification/read", false},
+        {"amplification/space", false},
+        {"cache/hit_rate", true}
+    };
+
+    if (base.contains("latency_us")) {
+        for (const auto& op : base["latency_us"].items()) {
+            for (const char* p : {"p50", "p99", "p99_9"})
+                metrics.push_back({"latency_us/" + op.key() + "/" + p, false});
+        }
+    }
+
+    std::cout << "Baseline : " << baselinePath << " ("
+              << base.value("git_revision", "unknown") << ")\n";
+    std::cout << "Candidate: " << candidatePath << " ("
+              << cand.value("git_revision", "unknown") << ")\n";
+
+    if (base.contains("config") && cand.contains("config") &&
+        base["config"] != cand["config"])
+        std::cout << "Warning: the runs used different configs\n";
+
+    const auto flags = std::cout.flags();
+    const auto precision = std::cout.precision();
+
+    std::cout << std::left << std::setw(28) << "metric"
+              << std::right << std::setw(14) << "baseline"
+              << std::setw(14) << "candidate"
+              << std::setw(10) << "change" << "\n";
+
+    std::cout << std::fixed << std::setprecision(2);
+
+    int regressions = 0;
+
+    for (const auto& [path, higherIsBetter] : metrics) {
+
+        double a, b;
+        if (!metric(base, path, a) || !metric(cand, path, b))
+            continue;
+
+        const double change = a != 0 ? (b - a) / std::fabs(a) * 100.0 : 0.0;
+        const double worse = higherIsBetter ? -change : change;
+        const bool regressed = worse > thresholdPercent;
+
+        if (regressed)
+            regressions++;
+
+        std::cout << std::left << std::setw(28) << path
+                  << std::right << std::setw(14) << a
+                  << std::setw(14) << b
+                  << std::setw(9) << std::showpos << change << std::noshowpos << "%"
+                  << (regressed ? "  REGRESSION" : "") << "\n";
+    }
+
+    std::cout.flags(flags);
+    std::cout.precision(precision);
+
+    std::cout << regressions << " regression(s) beyond "
+              << thresholdPercent << "%\n";
+
+    return regressions;
+}
@@ -0,0 +1,30 @@
+#pragma once
+#include <string>
+#include "Config.h"
+#include "BenchmarkRunner.h"
+
+class KVStore;
+
+// Machine-readable record of one benchmark run: config, git revision,
+// throughput, latency percentiles, amplification, cache and bloom stats.
+// Latencies are in microseconds.
+bool writeResultJson(const std::string& path,
+                     const BenchmarkConfig& config,
+                     const RunnerOptions& options,
+                     const std::string& strategy,
+                     const RunResult& result,
+                     const KVStore& db);
+
+// Default location for a run's record: benchmark_results/raw/<run>.json
+std::string defaultResultPath(const BenchmarkConfig& config,
+                              const std::string& strategy);
+
+// Short revision of the source tree, or "unknown" outside a git checkout
+std::string gitRevision();
+
+// Diffs two result files metric by metric and prints a table. A metric
+// that got worse by more than thresholdPercent is a regression.
+// Returns the number of regressions, or -1 if a file can't be read.
+int compareResults(const std::string& baselinePath,
+                   const std::string& candidatePath,
+                   double thresholdPercent);
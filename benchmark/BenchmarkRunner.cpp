@@ -0,0 +1,254 @@
+#include "BenchmarkRunner.h"
+#include "../include/KVStore.h"
+
+#include <thread>
+#include <atomic>
+#include <chrono>
+#include <random>
+#include <iomanip>
+#include <iostream>
+#include <algorithm>
+
+using Clock = std::chrono::steady_clock;
+
+BenchmarkRunner::BenchmarkRunner(KVStore& db,
+                                 const BenchmarkConfig& config,
+                                 const RunnerOptions& options)
+    : db(db),
+      config(config),
+      options(options),
+      keys(std::make_shared<KeySpace>()),
+      baseSeed(config.seed ? config.seed : std::random_device{}()) {
+
+    this->options.threads = std::max(options.threads, 1);
+}
+
+void BenchmarkRunner::runOperation(KVStore& db, const Operation& op, std::string& scratch) {
+
+    switch (op.type) {
+        case OperationType::PUT:
+            db.put(op.key, op.value);
+            break;
+
+        case OperationType::GET:
+            db.get(op.key, scratch);
+            break;
+
+        case OperationType::DELETE_OP:
+            db.deleteKey(op.key);
+            break;
+
+        case OperationType::SCAN: {
+            auto it = db.newIterator();
+            int n = 0;
+            for (it->seek(op.key); it->valid() && n < op.scan_length; it->next())
+                n++;
+            break;
+        }
+
+        case OperationType::READ_MODIFY_WRITE:
+            db.get(op.key, scratch);
+            db.put(op.key, op.value);
+            break;
+    }
+}
+
+void BenchmarkRunner::load() {
+
+    WorkloadGenerator generator(config, keys, baseSeed);
+
+    Operation op;
+    while (generator.nextLoad(op))
+        db.put(op.key, op.value);
+}
+
+void BenchmarkRunner::worker(int id, uint64_t ops, ThreadStats& stats) {
+
+    BenchmarkConfig threadConfig = config;
+    threadConfig.total_ops = static_cast<int>(ops);
+
+    // Distinct stream per thread, reproducible for a fixed --seed
+    WorkloadGenerator generator(threadConfig, keys,
+                                baseSeed + 0x9E3779B97F4A7C15ULL * (id + 1));
+
+    // Open loop: op k of this thread is scheduled at start + k * interval
+    const bool throttled = options.target_ops_per_sec > 0;
+    const auto interval = std::chrono::duration_cast<Clock::duration>(
+        std::chrono::duration<double>(
+            throttled ? options.threads / options.target_ops_per_sec : 0.0));
+
+    Operation op;
+    std::string scratch;
+
+    Clock::time_point scheduled = Clock::now();
+
+    while (generator.next(op)) {
+
+        Clock::time_point begin;
+
+        if (throttled) {
+            // Behind schedule: the backlog counts against this op.
+            // Ahead: timer oversleep is not the store's latency.
+            begin = Clock::now();
+            if (begin < scheduled) {
+                std::this_thread::sleep_until(scheduled);
+                begin = Clock::now();
+            } else {
+                begin = scheduled;
+            }
+            scheduled += interval;
+        } else {
+            begin = Clock::now();
+        }
+
+        runOperation(db, op, scratch);
+
+        const auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
+            Clock::now() - begin).count();
+
+        stats.latency[static_cast<size_t>(op.type)].record(
+            static_cast<uint64_t>(std::max<int64_t>(ns, 0)));
+    }
+}
+
+void BenchmarkRunner::collect(HistogramSnapshot (&out)[OPERATION_TYPE_COUNT]) const {
+
+    for (size_t t = 0; t < OPERATION_TYPE_COUNT; t++) {
+        out[t] = HistogramSnapshot();
+        for (const auto& stats : threadStats)
+            out[t].merge(stats->latency[t].snapshot());
+    }
+}
+
+RunResult BenchmarkRunner::run() {
+
+    const int threads = options.threads;
+    const uint64_t total = static_cast<uint64_t>(std::max(config.total_ops, 0));
+
+    threadStats.clear();
+    for (int i = 0; i < threads; i++)
+        threadStats.push_back(std::make_unique<ThreadStats>());
+
+    std::atomic<int> running(threads);
+    std::vector<std::thread> workers;
+
+    const auto start = Clock::now();
+
+    for (int i = 0; i < threads; i++) {
+        // Spread the remainder over the first threads
+        uint64_t share = total / threads + (static_cast<uint64_t>(i) < total % threads ? 1 : 0);
+
+        workers.emplace_back([this, i, share, &running] {
+            worker(i, share, *threadStats[i]);
+            running--;
+        });
+    }
+
+    // Interval reports: latency of the ops completed since the last line
+    if (options.report_interval_sec > 0) {
+
+        const auto period = std::chrono::duration_cast<Clock::duration>(
+            std::chrono::duration<double>(options.report_interval_sec));
+
+        HistogramSnapshot previous[OPERATION_TYPE_COUNT];
+        auto nextReport = start + period;
+        auto lastReport = start;
+
+        while (running.load() > 0) {
+
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+
+            if (Clock::now() < nextReport)
+                continue;
+
+            HistogramSnapshot current[OPERATION_TYPE_COUNT];
+            HistogramSnapshot delta[OPERATION_TYPE_COUNT];
+            collect(current);
+
+            uint64_t ops = 0;
+            for (size_t t = 0; t < OPERATION_TYPE_COUNT; t++) {
+                delta[t] = current[t].since(previous[t]);
+                ops += delta[t].count;
+                previous[t] = std::move(current[t]);
+            }
+
+            const auto now = Clock::now();
+            const double elapsed = std::chrono::duration<double>(now - start).count();
+            const double window = std::chrono::duration<double>(now - lastReport).count();
+            lastReport = now;
+
+            const auto flags = std::cout.flags();
+            std::cout << "[" << std::fixed << std::setprecision(1) << elapsed << "s] "
+                      << std::setprecision(0) << ops / window << " ops/sec\n";
+            std::cout.flags(flags);
+            std::cout << std::setprecision(6);
+
+            printLatencyTable(std::cout, delta);
+
+            nextReport += period;
+        }
+    }
+
+    for (auto& t : workers)
+        t.join();
+
+    RunResult result;
+    result.threads = threads;
+    result.seconds = std::chrono::duration<double>(Clock::now() - start).count();
+
+    collect(result.latency);
+
+    for (size_t t = 0; t < OPERATION_TYPE_COUNT; t++) {
+        result.total_ops += result.latency[t].count;
+        result.overall.merge(result.latency[t]);
+    }
+
+    return result;
+}
+
+void BenchmarkRunner::printLatencyTable(std::ostream& out,
+                                        const HistogramSnapshot (&latency)[OPERATION_TYPE_COUNT]) {
+
+    auto us = [](uint64_t ns) { return ns / 1000.0; };
+
+    const auto flags = out.flags();
+    const auto precision = out.precision();
+
+    out << "  " << std::left << std::setw(8) << "op"
+        << std::right << std::setw(10) << "count"
+        << std::setw(10) << "p50(us)"
+        << std::setw(10) << "p90"
+        << std::setw(10) << "p99"
+        << std::setw(10) << "p99.9"
+        << std::setw(10) << "max" << "\n";
+
+    out << std::fixed << std::setprecision(1);
+
+    for (size_t t = 0; t < OPERATION_TYPE_COUNT; t++) {
+
+        const HistogramSnapshot& h = latency[t];
+        if (h.count == 0)
+            continue;
+
+        out << "  " << std::left << std::setw(8) << operationName(static_cast<OperationType>(t))
+            << std::right << std::setw(10) << h.count
+            << std::setw(10) << us(h.percentile(50))
+            << std::setw(10) << us(h.percentile(90))
+            << std::setw(10) << us(h.percentile(99))
+            << std::setw(10) << us(h.percentile(99.9))
+            << std::setw(10) << us(h.max) << "\n";
+    }
+
+    out.flags(flags);
+    out.precision(precision);
+}
+
+void RunResult::print(std::ostream& out) const {
+
+    out << "Threads     : " << threads << "\n";
+    out << "Total Ops   : " << total_ops << "\n";
+    out << "Time        : " << seconds << " sec\n";
+    out << "Throughput  : " << throughput() << " ops/sec\n";
+    out << "Latency (overall run):\n";
+    BenchmarkRunner::printLatencyTable(out, latency);
+}
@@ -0,0 +1,73 @@
+#pragma once
+#include <string>
+#include <memory>
+#include <ostream>
+#include <cstdint>
+#include "Config.h"
+#include "Workload.h"
+#include "../include/Histogram.h"
+
+class KVStore;
+
+struct RunnerOptions {
+    int threads = 1;
+
+    // Total across all threads; 0 runs closed-loop as fast as possible.
+    // When set, latency is measured from each op's scheduled start, so
+    // time spent queued behind a slow op is counted.
+    double target_ops_per_sec = 0.0;
+
+    // Seconds between interval lines; 0 prints only the final summary
+    double report_interval_sec = 1.0;
+};
+
+struct RunResult {
+    int threads = 1;
+    double seconds = 0.0;
+    uint64_t total_ops = 0;
+
+    HistogramSnapshot latency[OPERATION_TYPE_COUNT];   // ns, per op type
+    HistogramSnapshot overall;                          // ns, all ops
+
+    double throughput() const { return seconds > 0 ? total_ops / seconds : 0.0; }
+
+    void print(std::ostream& out) const;
+};
+
+// Drives a workload against one KVStore from N client threads, each with
+// its own generator, and records per-op latency histograms.
+class BenchmarkRunner {
+public:
+    BenchmarkRunner(KVStore& db,
+                    const BenchmarkConfig& config,
+                    const RunnerOptions& options);
+
+    // YCSB load phase: inserts the initial records (untimed)
+    void load();
+
+    // Runs config.total_ops operations split across the threads
+    RunResult run();
+
+    static void runOperation(KVStore& db, const Operation& op, std::string& scratch);
+
+    // p50/p90/p99/p99.9/max table, one row per op type that ran
+    static void printLatencyTable(std::ostream& out,
+                                  const HistogramSnapshot (&latency)[OPERATION_TYPE_COUNT]);
+
+private:
+    struct ThreadStats {
+        Histogram latency[OPERATION_TYPE_COUNT];
+    };
+
+    void worker(int id, uint64_t ops, ThreadStats& stats);
+
+    void collect(HistogramSnapshot (&out)[OPERATION_TYPE_COUNT]) const;
+
+    KVStore& db;
+    BenchmarkConfig config;
+    RunnerOptions options;
+    std::shared_ptr<KeySpace> keys;
+    uint64_t baseSeed;
+
+    std::vector<std::unique_ptr<ThreadStats>> threadStats;
+};
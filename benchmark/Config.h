@@ -1,15 +1,34 @@
 #pragma once
 #include <string>
+#include <cstdint>
 
 enum class WorkloadType{
     WRITE_HEAVY,
     READ_HEAVY,
-    MIXED
+    MIXED,
+
+    // YCSB core workloads (operation mix and key distribution are preset)
+    YCSB_A,     // 50% read, 50% update, zipfian
+    YCSB_B,     // 95% read, 5% update, zipfian
+    YCSB_C,     // 100% read, zipfian
+    YCSB_D,     // 95% read, 5% insert, latest
+    YCSB_E,     // 95% scan, 5% insert, zipfian
+    YCSB_F      // 50% read, 50% read-modify-write, zipfian
 };
 
 enum class KeyDistribution{
     SEQUENTIAL,
-    RANDOM
+    RANDOM,             // uniform
+    ZIPFIAN,            // popular keys clustered at the low end
+    SCRAMBLED_ZIPFIAN,  // zipfian popularity, popular keys spread out
+    LATEST,             // recently inserted keys are the most popular
+    HOTSPOT             // hot_set_fraction of keys get hot_op_fraction of ops
+};
+
+enum class ValueSizeDistribution{
+    FIXED,      // value_size
+    UNIFORM,    // [value_size_min, value_size]
+    ZIPFIAN     // small values most common, up to value_size
 };
 
 struct BenchmarkConfig{
@@ -18,10 +37,67 @@ struct BenchmarkConfig{
     WorkloadType workload = WorkloadType::MIXED;
     KeyDistribution key_dist = KeyDistribution::RANDOM;
 
-    int key_space = 100000;   // range of keys
+    int key_space = 100000;   // range of keys (YCSB: records loaded first)
     int value_size = 100;     // bytes
 
+    ValueSizeDistribution value_dist = ValueSizeDistribution::FIXED;
+    int value_size_min = 1;
+
+    double zipf_theta = 0.99;
+
+    double hot_set_fraction = 0.2;
+    double hot_op_fraction = 0.8;
+
     double put_ratio = 0.5;
     double get_ratio = 0.45;
     double delete_ratio = 0.05;
-};
\ No newline at end of file
+
+    // YCSB operations (set by the presets, usable in custom mixes)
+    double insert_ratio = 0.0;
+    double scan_ratio = 0.0;
+    double rmw_ratio = 0.0;
+
+    int max_scan_length = 100;
+
+    uint64_t seed = 0;        // 0 = random seed
+};
+
+inline bool isYcsbWorkload(WorkloadType w) {
+    return w >= WorkloadType::YCSB_A;
+}
+
+inline const char* workloadName(WorkloadType w) {
+    switch (w) {
+        case WorkloadType::WRITE_HEAVY: return "write-heavy";
+        case WorkloadType::READ_HEAVY:  return "read-heavy";
+        case WorkloadType::MIXED:       return "mixed";
+        case WorkloadType::YCSB_A:      return "ycsb-a";
+        case WorkloadType::YCSB_B:      return "ycsb-b";
+        case WorkloadType::YCSB_C:      return "ycsb-c";
+        case WorkloadType::YCSB_D:      return "ycsb-d";
+        case WorkloadType::YCSB_E:      return "ycsb-e";
+        case WorkloadType::YCSB_F:      return "ycsb-f";
+    }
+    return "?";
+}
+
+inline const char* keyDistributionName(KeyDistribution d) {
+    switch (d) {
+        case KeyDistribution::SEQUENTIAL:        return "sequential";
+        case KeyDistribution::RANDOM:            return "uniform";
+        case KeyDistribution::ZIPFIAN:           return "zipfian";
+        case KeyDistribution::SCRAMBLED_ZIPFIAN: return "scrambled-zipfian";
+        case KeyDistribution::LATEST:            return "latest";
+        case KeyDistribution::HOTSPOT:           return "hotspot";
+    }
+    return "?";
+}
+
+inline const char* valueSizeDistributionName(ValueSizeDistribution d) {
+    switch (d) {
+        case ValueSizeDistribution::FIXED:   return "fixed";
+        case ValueSizeDistribution::UNIFORM: return "uniform";
+        case ValueSizeDistribution::ZIPFIAN: return "zipfian";
+    }
+    return "?";
+}
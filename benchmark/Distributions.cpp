@@ -0,0 +1,151 @@
+#include "Distributions.h"
+
+#include <cmath>
+#include <map>
+#include <mutex>
+
+// =======================
+// Helpers
+// =======================
+static double uniform01(BenchRng& rng) {
+    return std::uniform_real_distribution<double>(0.0, 1.0)(rng);
+}
+
+// sum_{i=1..n} 1 / i^theta, memoized per (theta, n) so per-thread
+// generators over 100M items don't each pay for it. A new n starts
+// from the largest sum already known below it; nothing is subtracted.
+static constexpr size_t MAX_MEMO_SIZES = 64;
+
+static double zeta(uint64_t n, double theta) {
+    static std::mutex mtx;
+    static std::map<double, std::map<uint64_t, double>> memo;
+
+    std::lock_guard<std::mutex> lock(mtx);
+
+    auto& sums = memo[theta];   // items summed -> partial sum
+
+    auto it = sums.upper_bound(n);
+    uint64_t from = 0;
+    double sum = 0;
+
+    if (it != sums.begin()) {
+        --it;
+        if (it->first == n)
+            return it->second;
+        from = it->first;
+        sum = it->second;
+    }
+
+    for (uint64_t i = from + 1; i <= n; i++)
+        sum += 1.0 / std::pow(static_cast<double>(i), theta);
+
+    sums[n] = sum;
+
+    // Item counts that grow with every insert would pile up; the
+    // largest sums are the useful starting points
+    while (sums.size() > MAX_MEMO_SIZES)
+        sums.erase(sums.begin());
+
+    return sum;
+}
+
+uint64_t fnvHash64(uint64_t v) {
+    uint64_t hash = 0xCBF29CE484222325ULL;
+
+    for (int i = 0; i < 8; i++) {
+        hash ^= v & 0xFF;
+        hash *= 0x100000001B3ULL;
+        v >>= 8;
+    }
+
+    return hash;
+}
+
+// =======================
+// Uniform
+// =======================
+uint64_t UniformGenerator::next(BenchRng& rng, uint64_t items) {
+    if (items == 0) return 0;
+    return std::uniform_int_distribution<uint64_t>(0, items - 1)(rng);
+}
+
+// =======================
+// Zipfian
+// =======================
+ZipfianGenerator::ZipfianGenerator(uint64_t items, double theta)
+    : items(0),
+      theta(theta),
+      alpha(1.0 / (1.0 - theta)),
+      zeta2(1.0 + std::pow(0.5, theta)),
+      zetan(0),
+      eta(0) {
+
+    resize(items == 0 ? 1 : items);
+}
+
+void ZipfianGenerator::resize(uint64_t newItems) {
+    items = newItems;
+    zetan = zeta(items, theta);
+    eta = (1.0 - std::pow(2.0 / items, 1.0 - theta)) / (1.0 - zeta2 / zetan);
+}
+
+uint64_t ZipfianGenerator::next(BenchRng& rng) {
+    const double u = uniform01(rng);
+    const double uz = u * zetan;
+
+    if (uz < 1.0) return 0;
+    if (uz < 1.0 + std::pow(0.5, theta)) return items > 1 ? 1 : 0;
+
+    uint64_t v = static_cast<uint64_t>(
+        items * std::pow(eta * u - eta + 1.0, alpha));
+
+    return v < items ? v : items - 1;
+}
+
+uint64_t ZipfianGenerator::next(BenchRng& rng, uint64_t n) {
+    if (n != items && n > 0)
+        resize(n);
+
+    return next(rng);
+}
+
+// =======================
+// Scrambled zipfian
+// =======================
+ScrambledZipfianGenerator::ScrambledZipfianGenerator(uint64_t items, double theta)
+    : zipf(items, theta) {}
+
+uint64_t ScrambledZipfianGenerator::next(BenchRng& rng, uint64_t items) {
+    if (items == 0) return 0;
+    return fnvHash64(zipf.next(rng, items)) % items;
+}
+
+// =======================
+// Latest
+// =======================
+LatestGenerator::LatestGenerator(uint64_t items, double theta)
+    : zipf(items, theta) {}
+
+uint64_t LatestGenerator::next(BenchRng& rng, uint64_t items) {
+    if (items == 0) return 0;
+    return items - 1 - zipf.next(rng, items);
+}
+
+// =======================
+// Hotspot
+// =======================
+HotspotGenerator::HotspotGenerator(double hotSetFraction, double hotOpFraction)
+    : hotSetFraction(hotSetFraction),
+      hotOpFraction(hotOpFraction) {}
+
+uint64_t HotspotGenerator::next(BenchRng& rng, uint64_t items) {
+    if (items == 0) return 0;
+
+    uint64_t hotItems = static_cast<uint64_t>(items * hotSetFraction);
+    if (hotItems == 0) hotItems = 1;
+
+    if (hotItems >= items || uniform01(rng) < hotOpFraction)
+        return std::uniform_int_distribution<uint64_t>(0, hotItems - 1)(rng);
+
+    return std::uniform_int_distribution<uint64_t>(hotItems, items - 1)(rng);
+}
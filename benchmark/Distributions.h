@@ -0,0 +1,71 @@
+#pragma once
+#include <cstdint>
+#include <random>
+
+// Key choosers used by the workload generator. Each draws an item number
+// in [0, items); generators are not thread-safe, use one per thread.
+
+using BenchRng = std::mt19937_64;
+
+class UniformGenerator {
+public:
+    uint64_t next(BenchRng& rng, uint64_t items);
+};
+
+// Gray et al., "Quickly Generating Billion-Record Synthetic Databases".
+// Item 0 is the most popular. The item count may grow between calls
+// (zeta is extended incrementally instead of recomputed).
+class ZipfianGenerator {
+public:
+    ZipfianGenerator(uint64_t items, double theta);
+
+    uint64_t next(BenchRng& rng);
+    uint64_t next(BenchRng& rng, uint64_t items);
+
+private:
+    void resize(uint64_t newItems);
+
+    uint64_t items;
+    double theta;
+    double alpha;
+    double zeta2;
+    double zetan;
+    double eta;
+};
+
+// Zipfian popularity, but popular items are scattered over the key space
+// by hashing instead of all sitting at the low end
+class ScrambledZipfianGenerator {
+public:
+    ScrambledZipfianGenerator(uint64_t items, double theta);
+
+    uint64_t next(BenchRng& rng, uint64_t items);
+
+private:
+    ZipfianGenerator zipf;
+};
+
+// The most recently inserted items are the most popular
+class LatestGenerator {
+public:
+    LatestGenerator(uint64_t items, double theta);
+
+    uint64_t next(BenchRng& rng, uint64_t items);
+
+private:
+    ZipfianGenerator zipf;
+};
+
+// A fixed fraction of the items receives a fixed fraction of the draws
+class HotspotGenerator {
+public:
+    HotspotGenerator(double hotSetFraction, double hotOpFraction);
+
+    uint64_t next(BenchRng& rng, uint64_t items);
+
+private:
+    double hotSetFraction;
+    double hotOpFraction;
+};
+
+uint64_t fnvHash64(uint64_t v);
@@ -1,69 +1,204 @@
 #include "Workload.h"
 #include <random>
-#include <sstream>
+#include <algorithm>
 
-std::mt19937 rng(std::random_device{}());
+static constexpr uint64_t ZIPF_INITIAL_ITEMS = 1000;
 
-WorkloadGenerator::WorkloadGenerator(const BenchmarkConfig& config)
-    : config(config) {}
-
-std::string WorkloadGenerator::generateKey(int i) {
-    if (config.key_dist == KeyDistribution::SEQUENTIAL) {
-        return "key_" + std::to_string(i);
-    } else {
-        return generateRandomKey();
+const char* operationName(OperationType type) {
+    switch (type) {
+        case OperationType::PUT:               return "PUT";
+        case OperationType::GET:               return "GET";
+        case OperationType::DELETE_OP:         return "DELETE";
+        case OperationType::SCAN:              return "SCAN";
+        case OperationType::READ_MODIFY_WRITE: return "RMW";
     }
+    return "?";
+}
+
+WorkloadGenerator::WorkloadGenerator(const BenchmarkConfig& cfg,
+                                     std::shared_ptr<KeySpace> keySpace,
+                                     uint64_t seed)
+    : config(cfg),
+      keys(keySpace ? std::move(keySpace) : std::make_shared<KeySpace>()),
+      rng(seed ? seed : (cfg.seed ? cfg.seed : std::random_device{}())),
+      zipfian(std::max(cfg.key_space, 1), cfg.zipf_theta),
+      scrambled(std::max(cfg.key_space, 1), cfg.zipf_theta),
+      latest(ZIPF_INITIAL_ITEMS, cfg.zipf_theta),
+      hotspot(cfg.hot_set_fraction, cfg.hot_op_fraction),
+      valueSizes(std::max(cfg.value_size - cfg.value_size_min + 1, 1), cfg.zipf_theta) {
+
+    applyPreset(config);
+
+    totalRatio = config.put_ratio + config.get_ratio + config.delete_ratio +
+                 config.insert_ratio + config.scan_ratio + config.rmw_ratio;
+    if (totalRatio <= 0) totalRatio = 1.0;
+
+    // Printable random bytes; each value is a window into this pool
+    std::uniform_int_distribution<int> ch('!', '~');
+    valuePool.resize(static_cast<size_t>(std::max(config.value_size, 1)) * 2);
+    for (char& c : valuePool)
+        c = static_cast<char>(ch(rng));
 }
 
-std::string WorkloadGenerator::generateRandomKey() {
-    std::uniform_int_distribution<int> dist(1, config.key_space);
-    return "key_" + std::to_string(dist(rng));
+void WorkloadGenerator::applyPreset(BenchmarkConfig& config) {
+
+    if (!isYcsbWorkload(config.workload))
+        return;
+
+    config.put_ratio = config.get_ratio = config.delete_ratio = 0.0;
+    config.insert_ratio = config.scan_ratio = config.rmw_ratio = 0.0;
+    config.key_dist = KeyDistribution::ZIPFIAN;
+
+    switch (config.workload) {
+        case WorkloadType::YCSB_A:
+            config.get_ratio = 0.5;
+            config.put_ratio = 0.5;
+            break;
+        case WorkloadType::YCSB_B:
+            config.get_ratio = 0.95;
+            config.put_ratio = 0.05;
+            break;
+        case WorkloadType::YCSB_C:
+            config.get_ratio = 1.0;
+            break;
+        case WorkloadType::YCSB_D:
+            config.get_ratio = 0.95;
+            config.insert_ratio = 0.05;
+            config.key_dist = KeyDistribution::LATEST;
+            break;
+        case WorkloadType::YCSB_E:
+            config.scan_ratio = 0.95;
+            config.insert_ratio = 0.05;
+            break;
+        case WorkloadType::YCSB_F:
+            config.get_ratio = 0.5;
+            config.rmw_ratio = 0.5;
+            break;
+        default:
+            break;
+    }
 }
 
-std::string WorkloadGenerator::generateValue() {
-    return std::string(config.value_size, 'x');
+std::string WorkloadGenerator::formatKey(uint64_t item) const {
+    // YCSB hashes insert order so new records don't all land at the end
+    if (isYcsbWorkload(config.workload))
+        return "user" + std::to_string(fnvHash64(item));
+
+    return "key_" + std::to_string(item);
 }
 
-OperationType WorkloadGenerator::chooseOperation() {
-    std::uniform_real_distribution<double> dist(0.0, 1.0);
+OperationType WorkloadGenerator::chooseOperation(bool& insert) {
+    std::uniform_real_distribution<double> dist(0.0, totalRatio);
     double r = dist(rng);
 
-    if (r < config.put_ratio) return OperationType::PUT;
-    else if (r < config.put_ratio + config.get_ratio) return OperationType::GET;
-    else return OperationType::DELETE_OP;
+    insert = false;
+
+    if ((r -= config.put_ratio) < 0) return OperationType::PUT;
+    if ((r -= config.get_ratio) < 0) return OperationType::GET;
+    if ((r -= config.delete_ratio) < 0) return OperationType::DELETE_OP;
+    if ((r -= config.scan_ratio) < 0) return OperationType::SCAN;
+    if ((r -= config.rmw_ratio) < 0) return OperationType::READ_MODIFY_WRITE;
+
+    // Inserts are PUTs of a fresh item
+    insert = true;
+    return OperationType::PUT;
+}
+
+uint64_t WorkloadGenerator::chooseItem() {
+
+    // Legacy workloads draw from the configured key space; YCSB from
+    // what has been inserted so far
+    uint64_t items = isYcsbWorkload(config.workload) ||
+                     config.key_dist == KeyDistribution::SEQUENTIAL
+                         ? keys->inserted.load(std::memory_order_relaxed)
+                         : static_cast<uint64_t>(config.key_space);
+
+    if (items == 0) items = 1;
+
+    switch (config.key_dist) {
+        case KeyDistribution::ZIPFIAN:           return zipfian.next(rng, items);
+        case KeyDistribution::SCRAMBLED_ZIPFIAN: return scrambled.next(rng, items);
+        case KeyDistribution::LATEST:            return latest.next(rng, items);
+        case KeyDistribution::HOTSPOT:           return hotspot.next(rng, items);
+        case KeyDistribution::SEQUENTIAL:
+        case KeyDistribution::RANDOM:
+        default:                                 return uniform.next(rng, items);
+    }
+}
+
+void WorkloadGenerator::generateValue(std::string& out) {
+
+    size_t size = config.value_size;
+
+    if (config.value_dist == ValueSizeDistribution::UNIFORM) {
+        size = std::uniform_int_distribution<int>(
+            config.value_size_min,
+            std::max(config.value_size_min, config.value_size))(rng);
+    } else if (config.value_dist == ValueSizeDistribution::ZIPFIAN) {
+        size = config.value_size_min + valueSizes.next(rng);
+    }
+
+    size = std::min(size, valuePool.size());
+
+    size_t offset = std::uniform_int_distribution<size_t>(
+        0, valuePool.size() - size)(rng);
+
+    out.assign(valuePool, offset, size);
+}
+
+bool WorkloadGenerator::nextLoad(Operation& op) {
+
+    if (loaded >= static_cast<uint64_t>(config.key_space))
+        return false;
+
+    loaded++;
+
+    op.type = OperationType::PUT;
+    op.key = formatKey(keys->inserted.fetch_add(1));
+    op.scan_length = 0;
+    generateValue(op.value);
+
+    return true;
+}
+
+bool WorkloadGenerator::next(Operation& op) {
+
+    if (issued >= static_cast<uint64_t>(config.total_ops))
+        return false;
+
+    issued++;
+
+    bool insert;
+    op.type = chooseOperation(insert);
+    op.scan_length = 0;
+    op.value.clear();
+
+    // Fresh item: YCSB inserts and sequential legacy puts
+    if (insert || (op.type == OperationType::PUT &&
+                   config.key_dist == KeyDistribution::SEQUENTIAL)) {
+        op.key = formatKey(keys->inserted.fetch_add(1));
+    } else {
+        op.key = formatKey(chooseItem());
+    }
+
+    if (op.type == OperationType::PUT ||
+        op.type == OperationType::READ_MODIFY_WRITE)
+        generateValue(op.value);
+
+    if (op.type == OperationType::SCAN)
+        op.scan_length = std::uniform_int_distribution<int>(
+            1, std::max(config.max_scan_length, 1))(rng);
+
+    return true;
 }
 
 std::vector<Operation> WorkloadGenerator::generate() {
     std::vector<Operation> ops;
+    ops.reserve(config.total_ops);
 
-    for (int i = 0; i < config.total_ops; i++) {
-        Operation op;
-        op.type = chooseOperation();
-
-        if (op.type == OperationType::PUT) {
-            op.key = generateKey(i);
-            op.value = generateValue();
-            existing_keys.push_back(op.key);
-        }
-        else if (op.type == OperationType::GET) {
-            if (!existing_keys.empty()) {
-                op.key = existing_keys[rng() % existing_keys.size()];
-            } else {
-                op.key = generateRandomKey();
-            }
-        }
-        else { // DELETE
-            if (!existing_keys.empty()) {
-                int idx = rng() % existing_keys.size();
-                op.key = existing_keys[idx];
-                existing_keys.erase(existing_keys.begin() + idx);
-            } else {
-                op.key = generateRandomKey();
-            }
-        }
-
+    Operation op;
+    while (next(op))
         ops.push_back(op);
-    }
 
     return ops;
-}
\ No newline at end of file
+}
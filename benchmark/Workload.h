@@ -1,33 +1,82 @@
 #pragma once
 #include <string>
 #include <vector>
+#include <memory>
+#include <atomic>
 #include "Config.h"
+#include "Distributions.h"
 
 enum class OperationType {
     PUT,
     GET,
-    DELETE_OP
+    DELETE_OP,
+    SCAN,               // read scan_length keys starting at key
+    READ_MODIFY_WRITE   // get, then put a new value
 };
 
+static constexpr size_t OPERATION_TYPE_COUNT = 5;
+
+const char* operationName(OperationType type);
+
 struct Operation {
     OperationType type;
     std::string key;
     std::string value;
+    int scan_length = 0;
+};
+
+// Items [0, inserted) exist. Shared by all generators of a run so that
+// inserts made through one are visible to the key choosers of the others.
+struct KeySpace {
+    std::atomic<uint64_t> inserted{0};
 };
 
+// Produces operations lazily, one at a time, so long runs need no
+// memory for the op list. YCSB workloads apply their preset mix and
+// key distribution on construction.
 class WorkloadGenerator {
 public:
-    WorkloadGenerator(const BenchmarkConfig& config);
+    WorkloadGenerator(const BenchmarkConfig& config,
+                      std::shared_ptr<KeySpace> keys = nullptr,
+                      uint64_t seed = 0);
 
+    // YCSB load phase: inserts items 0..key_space-1, then returns false
+    bool nextLoad(Operation& op);
+
+    // Run phase: false once total_ops operations were produced
+    bool next(Operation& op);
+
+    // Materializes the whole run phase (small runs only)
     std::vector<Operation> generate();
 
+    const BenchmarkConfig& getConfig() const { return config; }
+
+    std::string formatKey(uint64_t item) const;
+
+    // Fills in a YCSB workload's fixed operation mix and key distribution
+    static void applyPreset(BenchmarkConfig& config);
+
 private:
+
+    // `insert` is set for a PUT of a fresh item
+    OperationType chooseOperation(bool& insert);
+    uint64_t chooseItem();
+    void generateValue(std::string& out);
+
     BenchmarkConfig config;
+    std::shared_ptr<KeySpace> keys;
+    BenchRng rng;
+
+    UniformGenerator uniform;
+    ZipfianGenerator zipfian;
+    ScrambledZipfianGenerator scrambled;
+    LatestGenerator latest;
+    HotspotGenerator hotspot;
 
-    std::string generateKey(int i);
-    std::string generateRandomKey();
-    std::string generateValue();
-    OperationType chooseOperation();
+    ZipfianGenerator valueSizes;
+    std::string valuePool;   // random bytes that values are cut from
 
-    std::vector<std::string> existing_keys;
-};
\ No newline at end of file
+    double totalRatio = 1.0;
+    uint64_t issued = 0;
+    uint64_t loaded = 0;
+};
@@ -1,8 +1,12 @@
 #include <iostream>
 #include <chrono>
 #include <filesystem>
+#include <string>
+#include <cstdlib>
 #include "Workload.h"
 #include "Config.h"
+#include "BenchmarkRunner.h"
+#include "BenchmarkReport.h"
 #include "../include/KVStore.h"
 
 void cleanBenchmarkState() {
@@ -13,11 +17,23 @@ void cleanBenchmarkState() {
     // Remove metadata files
     fs::remove("metadata/wal.log");
     fs::remove("metadata/manifest.txt");
+    fs::remove("metadata/MANIFEST");
     fs::remove("metadata/stats.dat");
 
-    // Remove old SSTables from correct directory
-    if (fs::exists("data/sstables")) {
-        for (const auto& entry : fs::directory_iterator("data/sstables")) {
+    // Sealed WAL files (wal.log.<n>)
+    if (fs::exists("metadata")) {
+        for (const auto& entry : fs::directory_iterator("metadata")) {
+            if (entry.path().filename().string().rfind("wal.log.", 0) == 0) {
+                fs::remove(entry.path());
+            }
+        }
+    }
+
+    // Remove old SSTables (flushes) and compaction outputs
+    for (const char* dir : {"data/sstables", "data"}) {
+        if (!fs::exists(dir)) continue;
+
+        for (const auto& entry : fs::directory_iterator(dir)) {
             if (entry.path().extension() == ".dat") {
                 fs::remove(entry.path());
             }
@@ -27,12 +43,105 @@ void cleanBenchmarkState() {
     std::cout << "[0] Clean benchmark state ready.\n";
 }
 
-int main() {
+// --name=value overrides on top of the defaults in main()
+static bool parseOption(const std::string& arg,
+                        BenchmarkConfig& config,
+                        RunnerOptions& options,
+                        std::string& strategy,
+                        std::string& jsonPath) {
+
+    size_t eq = arg.find('=');
+    if (arg.rfind("--", 0) != 0 || eq == std::string::npos)
+        return false;
+
+    const std::string name = arg.substr(2, eq - 2);
+    const std::string value = arg.substr(eq + 1);
+
+    if (name == "workload") {
+        if (value == "write-heavy")     config.workload = WorkloadType::WRITE_HEAVY;
+        else if (value == "read-heavy") config.workload = WorkloadType::READ_HEAVY;
+        else if (value == "mixed")      config.workload = WorkloadType::MIXED;
+        else if (value == "ycsb-a")     config.workload = WorkloadType::YCSB_A;
+        else if (value == "ycsb-b")     config.workload = WorkloadType::YCSB_B;
+        else if (value == "ycsb-c")     config.workload = WorkloadType::YCSB_C;
+        else if (value == "ycsb-d")     config.workload = WorkloadType::YCSB_D;
+        else if (value == "ycsb-e")     config.workload = WorkloadType::YCSB_E;
+        else if (value == "ycsb-f")     config.workload = WorkloadType::YCSB_F;
+        else return false;
+    }
+    else if (name == "dist") {
+        if (value == "sequential")             config.key_dist = KeyDistribution::SEQUENTIAL;
+        else if (value == "uniform")           config.key_dist = KeyDistribution::RANDOM;
+        else if (value == "zipfian")           config.key_dist = KeyDistribution::ZIPFIAN;
+        else if (value == "scrambled-zipfian") config.key_dist = KeyDistribution::SCRAMBLED_ZIPFIAN;
+        else if (value == "latest")            config.key_dist = KeyDistribution::LATEST;
+        else if (value == "hotspot")           config.key_dist = KeyDistribution::HOTSPOT;
+        else return false;
+    }
+    else if (name == "value-dist") {
+        if (value == "fixed")        config.value_dist = ValueSizeDistribution::FIXED;
+        else if (value == "uniform") config.value_dist = ValueSizeDistribution::UNIFORM;
+        else if (value == "zipfian") config.value_dist = ValueSizeDistribution::ZIPFIAN;
+        else return false;
+    }
+    else if (name == "ops")         config.total_ops = std::atoi(value.c_str());
+    else if (name == "keys")        config.key_space = std::atoi(value.c_str());
+    else if (name == "value-size")  config.value_size = std::atoi(value.c_str());
+    else if (name == "value-min")   config.value_size_min = std::atoi(value.c_str());
+    else if (name == "theta")       config.zipf_theta = std::atof(value.c_str());
+    else if (name == "hot-set")     config.hot_set_fraction = std::atof(value.c_str());
+    else if (name == "hot-ops")     config.hot_op_fraction = std::atof(value.c_str());
+    else if (name == "scan-length") config.max_scan_length = std::atoi(value.c_str());
+    else if (name == "seed")        config.seed = std::strtoull(value.c_str(), nullptr, 10);
+    else if (name == "threads")     options.threads = std::atoi(value.c_str());
+    else if (name == "rate")        options.target_ops_per_sec = std::atof(value.c_str());
+    else if (name == "interval")    options.report_interval_sec = std::atof(value.c_str());
+    else if (name == "strategy")    strategy = value;
+    else if (name == "json")        jsonPath = value;
+    else return false;
+
+    return true;
+}
+
+// compare <baseline.json> <candidate.json> [--threshold=<percent>]
+static int compareMain(int argc, char* argv[]) {
+
+    if (argc < 4) {
+        std::cerr << "Usage: benchmark_runner compare <baseline.json> "
+                     "<candidate.json> [--threshold=<percent>]\n";
+        return 2;
+    }
+
+    double threshold = 5.0;
+
+    for (int i = 4; i < argc; i++) {
+        const std::string arg = argv[i];
+        if (arg.rfind("--threshold=", 0) == 0) {
+            threshold = std::atof(arg.c_str() + 12);
+        } else {
+            std::cerr << "Unknown option: " << arg << "\n";
+            return 2;
+        }
+    }
+
+    int regressions = compareResults(argv[2], argv[3], threshold);
+
+    if (regressions < 0) return 2;
+    return regressions > 0 ? 1 : 0;
+}
+
+int main(int argc, char* argv[]) {
+    if (argc > 1 && std::string(argv[1]) == "compare")
+        return compareMain(argc, argv);
+
     cleanBenchmarkState();
 
     std::cout << "[1] Benchmark started...\n";
 
     BenchmarkConfig config;
+    RunnerOptions options;
+    std::string strategy = "tiering";
+    std::string jsonPath;
 
     config.total_ops = 100000;
     config.workload = WorkloadType::READ_HEAVY;
@@ -42,60 +151,52 @@ int main() {
     config.get_ratio = 0.15;
     config.delete_ratio = 0.05;
 
-    std::cout << "[2] Generating workload...\n";
-    WorkloadGenerator generator(config);
-    auto ops = generator.generate();
-    std::cout << "[3] Workload generated: " << ops.size() << " ops\n";
-
-    std::cout << "[4] Initializing KVStore...\n";
-    KVStore db("config/system_config.json", "tiering");
-    std::cout << "[5] KVStore initialized successfully.\n";
+    for (int i = 1; i < argc; i++) {
+        if (!parseOption(argv[i], config, options, strategy, jsonPath)) {
+            std::cerr << "Unknown option: " << argv[i] << "\n";
+            return 1;
+        }
+    }
 
-    std::cout << "[6] Running benchmark...\n";
-    auto start = std::chrono::high_resolution_clock::now();
+    // Record the mix that actually runs
+    WorkloadGenerator::applyPreset(config);
 
-    int count = 0;
-    for (auto& op : ops) {
-        count++;
+    std::cout << "[2] Initializing KVStore...\n";
+    KVStore db("config/system_config.json", strategy);
+    std::cout << "[3] KVStore initialized successfully.\n";
 
-      //  std::cout << "Running op #" << count << " ... ";
+    // Each client thread generates its operations lazily
+    BenchmarkRunner runner(db, config, options);
 
-        if (op.type == OperationType::PUT) {
-           // std::cout << "PUT(" << op.key << ")\n";
-            db.put(op.key, op.value);
-        }
-        else if (op.type == OperationType::GET) {
-          //  std::cout << "GET(" << op.key << ")\n";
-            std::string value;
-            db.get(op.key, value);
-        }
-        else {
-          //  std::cout << "DELETE(" << op.key << ")\n";
-            db.deleteKey(op.key);
-        }
-
-       // std::cout << "Done op #" << count << "\n";
+    // YCSB: insert the initial records before timing starts
+    if (isYcsbWorkload(config.workload)) {
+        std::cout << "[4] Loading " << config.key_space << " records...\n";
+        runner.load();
     }
 
-    std::cout << "[7] Flushing DB...\n";
-    db.flush();
-
-    auto end = std::chrono::high_resolution_clock::now();
+    std::cout << "[5] Running " << config.total_ops << " ops on "
+              << options.threads << " thread(s)...\n";
+    RunResult result = runner.run();
 
-    double seconds = std::chrono::duration<double>(end - start).count();
+    std::cout << "[6] Flushing DB...\n";
+    db.flush();
 
     std::cout << "\n==============================\n";
     std::cout << "AuroraKV Benchmark Result\n";
     std::cout << "==============================\n";
-    std::cout << "Total Ops   : " << config.total_ops << "\n";
-    std::cout << "Time        : " << seconds << " sec\n";
-    std::cout << "Throughput  : " << (config.total_ops / seconds) << " ops/sec\n";
+    result.print(std::cout);
     std::cout << "==============================\n\n";
 
-    std::cout << "[8] Printing DB stats...\n";
+    std::cout << "[7] Printing DB stats...\n";
     db.printStats();
 
-    std::cout << "[9] Benchmark completed successfully.\n";
+    if (jsonPath.empty())
+        jsonPath = defaultResultPath(config, strategy);
+
+    if (writeResultJson(jsonPath, config, options, strategy, result, db))
+        std::cout << "Result record: " << jsonPath << "\n";
+
+    std::cout << "[8] Benchmark completed successfully.\n";
 
     return 0;
 }
\ No newline at end of file
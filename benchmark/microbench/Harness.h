@@ -0,0 +1,125 @@
+#pragma once
+#include <string>
+#include <vector>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <iomanip>
+#include <iostream>
+#include <algorithm>
+#include <functional>
+
+// Minimal timing harness for the engine's hot components: warmup runs,
+// then timed repetitions, reported as ns/op with spread across the
+// repetitions. No dependencies beyond the standard library.
+
+// Keeps the compiler from discarding a computed value
+template <class T>
+inline void doNotOptimize(const T& value) {
+#if defined(__GNUC__) || defined(__clang__)
+    asm volatile("" : : "r,m"(value) : "memory");
+#else
+    static volatile const void* sink;
+    sink = &value;
+#endif
+}
+
+struct MicroResult {
+    std::string name;
+    uint64_t opsPerRep = 0;
+    double meanNs = 0;     // ns/op averaged over repetitions
+    double stddevNs = 0;
+    double minNs = 0;
+    double maxNs = 0;
+};
+
+class MicroHarness {
+public:
+    MicroHarness(int warmup, int repetitions, std::string filter)
+        : warmup(warmup),
+          repetitions(std::max(repetitions, 1)),
+          filter(std::move(filter)) {
+
+        std::cout << std::left << std::setw(52) << "benchmark"
+                  << std::right << std::setw(12) << "ops/rep"
+                  << std::setw(12) << "ns/op"
+                  << std::setw(10) << "+/-"
+                  << std::setw(12) << "min"
+                  << std::setw(12) << "max" << "\n";
+    }
+
+    bool enabled(const std::string& name) const {
+        return filter.empty() || name.find(filter) != std::string::npos;
+    }
+
+    // `body` performs `ops` operations per call. `setup` (optional) runs
+    // untimed before every call, e.g. to reset a structure that `body`
+    // fills up.
+    void run(const std::string& name,
+             uint64_t ops,
+             const std::function<void()>& body,
+             const std::function<void()>& setup = nullptr) {
+
+        if (!enabled(name) || ops == 0)
+            return;
+
+        for (int i = 0; i < warmup; i++) {
+            if (setup) setup();
+            body();
+        }
+
+        std::vector<double> samples;
+        samples.reserve(repetitions);
+
+        for (int i = 0; i < repetitions; i++) {
+            if (setup) setup();
+
+            auto start = std::chrono::steady_clock::now();
+            body();
+            auto end = std::chrono::steady_clock::now();
+
+            samples.push_back(
+                std::chrono::duration<double, std::nano>(end - start).count() / ops);
+        }
+
+        MicroResult r;
+        r.name = name;
+        r.opsPerRep = ops;
+
+        double sum = 0;
+        for (double s : samples) sum += s;
+        r.meanNs = sum / samples.size();
+
+        double sq = 0;
+        for (double s : samples) sq += (s - r.meanNs) * (s - r.meanNs);
+        r.stddevNs = samples.size() > 1 ? std::sqrt(sq / (samples.size() - 1)) : 0.0;
+
+        r.minNs = *std::min_element(samples.begin(), samples.end());
+        r.maxNs = *std::max_element(samples.begin(), samples.end());
+
+        print(r);
+        results.push_back(r);
+    }
+
+    const std::vector<MicroResult>& getResults() const { return results; }
+
+private:
+    static void print(const MicroResult& r) {
+        const auto flags = std::cout.flags();
+
+        std::cout << std::left << std::setw(52) << r.name
+                  << std::right << std::setw(12) << r.opsPerRep
+                  << std::fixed << std::setprecision(1)
+                  << std::setw(12) << r.meanNs
+                  << std::setw(10) << r.stddevNs
+                  << std::setw(12) << r.minNs
+                  << std::setw(12) << r.maxNs << "\n";
+
+        std::cout.flags(flags);
+    }
+
+    int warmup;
+    int repetitions;
+    std::string filter;
+    std::vector<MicroResult> results;
+};
@@ -0,0 +1,295 @@
+#include <string>
+#include <vector>
+#include <memory>
+#include <random>
+#include <cstdio>
+#include <cstdlib>
+#include <sstream>
+#include <iostream>
+#include <algorithm>
+#include <limits>
+#include <filesystem>
+
+#include "Harness.h"
+
+#include "../../include/BloomFilter.h"
+#include "../../include/MemTable.h"
+#include "../../include/MemTableIterator.h"
+#include "../../include/MergeIterator.h"
+#include "../../include/SSTable.h"
+#include "../../include/BlockCache.h"
+#include "../../include/LRUCache.h"
+#include "../../include/WAL.h"
+
+// Microbenchmarks for the engine's hot components, run in isolation.
+//
+//   ./microbench [--keys=1000,100000] [--value-size=100] [--reps=5]
+//                [--warmup=1] [--filter=<substring>]
+
+static const std::string SCRATCH_DIR = "microbench_tmp";
+
+struct Options {
+    std::vector<uint64_t> keyCounts = {1000, 100000};
+    std::vector<size_t> valueSizes = {100};
+    int repetitions = 5;
+    int warmup = 1;
+    std::string filter;
+};
+
+static std::vector<uint64_t> parseList(const std::string& s) {
+    std::vector<uint64_t> out;
+    std::stringstream ss(s);
+    std::string item;
+    while (std::getline(ss, item, ','))
+        if (!item.empty()) out.push_back(std::strtoull(item.c_str(), nullptr, 10));
+    return out;
+}
+
+// Fixed-width so lexical order matches numeric order
+static std::string makeKey(uint64_t i) {
+    char buf[32];
+    std::snprintf(buf, sizeof(buf), "key%012llu", static_cast<unsigned long long>(i));
+    return buf;
+}
+
+struct Dataset {
+    std::vector<std::string> keys;      // sorted, present
+    std::vector<std::string> missing;   // sorted between the present keys
+    std::vector<size_t> order;          // random probe order
+    std::string value;
+
+    Dataset(uint64_t n, size_t valueSize) : value(valueSize, 'v') {
+        keys.reserve(n);
+        missing.reserve(n);
+        for (uint64_t i = 0; i < n; i++) {
+            keys.push_back(makeKey(i * 2));
+            missing.push_back(makeKey(i * 2 + 1));
+        }
+
+        order.resize(n);
+        for (size_t i = 0; i < n; i++) order[i] = i;
+        std::shuffle(order.begin(), order.end(), std::mt19937_64(42));
+    }
+};
+
+static std::string label(const std::string& name, uint64_t keys, size_t valueSize) {
+    return name + " keys=" + std::to_string(keys) + " val=" + std::to_string(valueSize);
+}
+
+// =======================
+// COMPONENTS
+// =======================
+static void benchBloom(MicroHarness& h, const Dataset& d) {
+
+    const uint64_t n = d.keys.size();
+    const size_t bits = n * 10;       // 10 bits per key
+    const size_t hashes = 3;
+
+    std::unique_ptr<BloomFilter> filter;
+
+    h.run(label("BloomFilter::add", n, d.value.size()), n,
+          [&] { for (const auto& k : d.keys) filter->add(k); },
+          [&] { filter = std::make_unique<BloomFilter>(bits, hashes); });
+
+    filter = std::make_unique<BloomFilter>(bits, hashes);
+    for (const auto& k : d.keys) filter->add(k);
+
+    h.run(label("BloomFilter::mightContain/hit", n, d.value.size()), n, [&] {
+        for (size_t i : d.order) doNotOptimize(filter->mightContain(d.keys[i]));
+    });
+
+    h.run(label("BloomFilter::mightContain/miss", n, d.value.size()), n, [&] {
+        for (size_t i : d.order) doNotOptimize(filter->mightContain(d.missing[i]));
+    });
+}
+
+// MemTable byte limit: the benchmarks fill tables past any real write
+// buffer size and never flush them
+static constexpr size_t UNBOUNDED_MEMTABLE_BYTES = std::numeric_limits<size_t>::max();
+
+static void benchMemTable(MicroHarness& h, const Dataset& d) {
+
+    const uint64_t n = d.keys.size();
+    std::unique_ptr<MemTable> mem;
+
+    h.run(label("MemTable::put", n, d.value.size()), n,
+          [&] {
+              SequenceNumber seq = 1;
+              for (size_t i : d.order) mem->put(d.keys[i], d.value, seq++);
+          },
+          [&] { mem = std::make_unique<MemTable>(UNBOUNDED_MEMTABLE_BYTES); });
+
+    mem = std::make_unique<MemTable>(UNBOUNDED_MEMTABLE_BYTES);
+    SequenceNumber seq = 1;
+    for (const auto& k : d.keys) mem->put(k, d.value, seq++);
+
+    std::string value;
+
+    h.run(label("MemTable::get/hit", n, d.value.size()), n, [&] {
+        for (size_t i : d.order) doNotOptimize(mem->get(d.keys[i], value));
+    });
+
+    h.run(label("MemTable::get/miss", n, d.value.size()), n, [&] {
+        for (size_t i : d.order) doNotOptimize(mem->get(d.missing[i], value));
+    });
+}
+
+static void benchSSTable(MicroHarness& h, const Dataset& d) {
+
+    const uint64_t n = d.keys.size();
+    const size_t bits = n * 10;
+    const std::string path = SCRATCH_DIR + "/sstable_" + std::to_string(n) + ".dat";
+
+    {
+        MemTable mem(UNBOUNDED_MEMTABLE_BYTES);
+        SequenceNumber seq = 1;
+        for (const auto& k : d.keys) mem.put(k, d.value, seq++);
+
+        SSTable writer(path, bits, 3);
+        MemTableIterator it(mem.getData());
+        writer.writeToDisk(it);
+    }
+
+    SSTable table(path, bits, 3);
+    std::string value;
+
+    h.run(label("SSTable::get/hit uncached", n, d.value.size()), n, [&] {
+        for (size_t i : d.order) doNotOptimize(table.get(d.keys[i], value));
+    });
+
+    h.run(label("SSTable::get/miss", n, d.value.size()), n, [&] {
+        for (size_t i : d.order) doNotOptimize(table.get(d.missing[i], value));
+    });
+
+    // Large enough to hold every block once warm
+    BlockCache cache(n);
+    SSTable cached(path, bits, 3);
+    cached.setBlockCache(&cache);
+
+    h.run(label("SSTable::get/hit block-cached", n, d.value.size()), n, [&] {
+        for (size_t i : d.order) doNotOptimize(cached.get(d.keys[i], value));
+    });
+}
+
+static void benchMergeIterator(MicroHarness& h, const Dataset& d) {
+
+    const uint64_t n = d.keys.size();
+    const size_t fanIn = 8;
+
+    // Keys dealt round-robin so every step switches inputs
+    std::vector<std::unique_ptr<MemTable>> tables;
+    for (size_t t = 0; t < fanIn; t++)
+        tables.push_back(std::make_unique<MemTable>(UNBOUNDED_MEMTABLE_BYTES));
+
+    for (size_t i = 0; i < n; i++)
+        tables[i % fanIn]->put(d.keys[i], d.value, i + 1);
+
+    h.run(label("MergeIterator scan fan-in=8", n, d.value.size()), n, [&] {
+        std::vector<std::unique_ptr<Iterator>> owned;
+        std::vector<Iterator*> inputs;
+        for (auto& t : tables) {
+            owned.push_back(std::make_unique<MemTableIterator>(t->getData()));
+            inputs.push_back(owned.back().get());
+        }
+
+        MergeIterator merged(inputs);
+        size_t bytes = 0;
+        for (; merged.valid(); merged.next())
+            bytes += merged.key().size() + merged.value().size();
+        doNotOptimize(bytes);
+    });
+}
+
+static void benchLRUCache(MicroHarness& h, const Dataset& d) {
+
+    const uint64_t n = d.keys.size();
+
+    std::unique_ptr<LRUCache> cache;
+
+    h.run(label("LRUCache::put", n, d.value.size()), n,
+          [&] { for (size_t i : d.order) cache->put(d.keys[i], d.value); },
+          [&] { cache = std::make_unique<LRUCache>(n); });
+
+    cache = std::make_unique<LRUCache>(n);
+    for (const auto& k : d.keys) cache->put(k, d.value);
+
+    PinnableSlice value;
+
+    h.run(label("LRUCache::get/hit", n, d.value.size()), n, [&] {
+        for (size_t i : d.order) doNotOptimize(cache->get(d.keys[i], value));
+    });
+
+    h.run(label("LRUCache::get/miss", n, d.value.size()), n, [&] {
+        for (size_t i : d.order) doNotOptimize(cache->get(d.missing[i], value));
+    });
+}
+
+static void benchWAL(MicroHarness& h, const Dataset& d) {
+
+    const uint64_t n = d.keys.size();
+    const std::string path = SCRATCH_DIR + "/wal.log";
+
+    std::unique_ptr<WAL> wal;
+
+    h.run(label("WAL::logPut", n, d.value.size()), n,
+          [&] {
+              SequenceNumber seq = 1;
+              for (const auto& k : d.keys) wal->logPut(k, d.value, seq++);
+              wal->flush();
+          },
+          [&] {
+              wal.reset();
+              std::filesystem::remove(path);
+              wal = std::make_unique<WAL>(path);
+          });
+}
+
+// =======================
+// MAIN
+// =======================
+int main(int argc, char* argv[]) {
+
+    Options options;
+
+    for (int i = 1; i < argc; i++) {
+        const std::string arg = argv[i];
+        const size_t eq = arg.find('=');
+        const std::string name = arg.substr(0, eq);
+        const std::string value = eq == std::string::npos ? "" : arg.substr(eq + 1);
+
+        if (name == "--keys")            options.keyCounts = parseList(value);
+        else if (name == "--value-size") {
+            options.valueSizes.clear();
+            for (uint64_t v : parseList(value)) options.valueSizes.push_back(v);
+        }
+        else if (name == "--reps")       options.repetitions = std::atoi(value.c_str());
+        else if (name == "--warmup")     options.warmup = std::atoi(value.c_str());
+        else if (name == "--filter")     options.filter = value;
+        else {
+            std::cerr << "Unknown option: " << arg << "\n";
+            return 1;
+        }
+    }
+
+    std::filesystem::create_directories(SCRATCH_DIR);
+
+    MicroHarness harness(options.warmup, options.repetitions, options.filter);
+
+    for (uint64_t keys : options.keyCounts) {
+        for (size_t valueSize : options.valueSizes) {
+
+            Dataset data(keys, valueSize);
+
+            benchBloom(harness, data);
+            benchMemTable(harness, data);
+            benchSSTable(harness, data);
+            benchMergeIterator(harness, data);
+            benchLRUCache(harness, data);
+            benchWAL(harness, data);
+        }
+    }
+
+    std::filesystem::remove_all(SCRATCH_DIR);
+
+    return 0;
+}
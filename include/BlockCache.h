@@ -4,45 +4,107 @@
 #include <unordered_map>
 #include <list>
 #include <string>
+#include <memory>
+#include <cstdint>
+#include <mutex>
+#include <atomic>
+#include <limits>
 
+#include "PerfContext.h"
+
+// LRU cache of raw SSTable data blocks, keyed by "<file>#<blockOffset>".
+// Blocks are shared so readers can keep referencing a block after it
+// has been evicted here.
 class BlockCache {
 private:
+    using Block = std::shared_ptr<const std::string>;
+
     size_t capacity;
 
-    std::list<std::pair<std::string, std::string>> lru;
+    // Memory limit on top of the block count (KVStore's memory budget)
+    std::atomic<size_t> capacityBytes{std::numeric_limits<size_t>::max()};
+    std::atomic<size_t> usage{0};
+
+    // Key, block buffer, list and hash-map nodes with allocator headers
+    static size_t charge(const std::string& key, const Block& block) {
+        return key.capacity() + block->capacity() +
+               sizeof(std::pair<std::string, Block>) + 8 * sizeof(void*) + 4 * sizeof(size_t);
+    }
+
+    // Drops LRU blocks until both limits hold (mtx held)
+    void evictLocked() {
+        while (!lru.empty() && (map.size() > capacity || usage > capacityBytes)) {
+            usage -= charge(lru.back().first, lru.back().second);
+            map.erase(lru.back().first);
+            lru.pop_back();
+        }
+    }
+
+    std::list<std::pair<std::string, Block>> lru;
 
     std::unordered_map<std::string,
-        std::list<std::pair<std::string, std::string>>::iterator> map;
+        std::list<std::pair<std::string, Block>>::iterator> map;
+
+    std::mutex mtx;
 
 public:
     BlockCache(size_t cap) : capacity(cap) {}
 
-    bool get(const std::string& key, std::string& value) {
+    static std::string blockKey(const std::string& file, uint64_t offset) {
+        return file + "#" + std::to_string(offset);
+    }
+
+    bool get(const std::string& key, Block& block) {
+        std::lock_guard<std::mutex> lock(mtx);
+
         auto it = map.find(key);
-        if (it == map.end()) return false;
+        if (it == map.end()) {
+            PERF_COUNTER_ADD(blockCacheMisses, 1);
+            return false;
+        }
 
+        PERF_COUNTER_ADD(blockCacheHits, 1);
         lru.splice(lru.begin(), lru, it->second);
-        value = it->second->second;
+        block = it->second->second;
         return true;
     }
 
-    void put(const std::string& key, const std::string& value) {
+    void put(const std::string& key, Block block) {
+        std::lock_guard<std::mutex> lock(mtx);
+
         auto it = map.find(key);
 
         if (it != map.end()) {
+            usage -= charge(it->second->first, it->second->second);
             lru.erase(it->second);
             map.erase(it);
         }
 
-        lru.push_front({key, value});
+        lru.push_front({key, std::move(block)});
         map[key] = lru.begin();
+        usage += charge(lru.front().first, lru.front().second);
 
-        if (map.size() > capacity) {
-            auto last = lru.back();
-            map.erase(last.first);
-            lru.pop_back();
-        }
+        evictLocked();
     }
+
+    // Block limit; evicts down to it right away if over it
+    void setCapacity(size_t blocks) {
+        std::lock_guard<std::mutex> lock(mtx);
+        capacity = blocks;
+        evictLocked();
+    }
+
+    // Evicts down to `bytes` right away if over it
+    void setCapacityBytes(size_t bytes) {
+        std::lock_guard<std::mutex> lock(mtx);
+        capacityBytes = bytes;
+        evictLocked();
+    }
+
+    size_t getCapacityBytes() const { return capacityBytes.load(); }
+
+    // Blocks held here; readers may keep evicted ones alive a while
+    size_t getUsage() const { return usage.load(); }
 };
 
-#endif
\ No newline at end of file
+#endif
@@ -5,6 +5,8 @@
 #include <string>
 #include <cstdint>
 
+#include "Slice.h"
+
 
 
 // Probabilistic data structure for fast membership checks.
@@ -19,15 +21,19 @@ void serialize(std::ofstream& out) const;
     BloomFilter(size_t bitSize, size_t hashCount);
 
     // Insert a key into the filter
-    void add(const std::string& key);
+    void add(const Slice& key);
 
     // Returns false if key is definitely not present
     // Returns true if key may be present
-    bool mightContain(const std::string& key) const;
+    bool mightContain(const Slice& key) const;
+
+    // Bytes of the bit array (one byte per bit)
+    size_t memoryUsage() const { return bitArray.capacity(); }
 
 private:
 
-    size_t hash(const std::string& key, size_t seed) const;
+    // Double hashing: probe i = h1 + i * h2, one key hash per call
+    size_t hash(const Slice& key) const;
 
 private:
 
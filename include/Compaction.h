@@ -2,10 +2,57 @@
 #define COMPACTION_H
 
 #include <vector>
+#include <string>
+#include <set>
+#include <memory>
+#include <algorithm>
 #include "SSTable.h"
+#include "InternalKey.h"
+#include "Statistics.h"
+#include "RateLimiter.h"
+#include "CompactionIterator.h"
 
 
-// Handles SSTable merging and cleanup
+// One unit of compaction work: a file of `level` merged with the files
+// of level + 1 it overlaps. Its inputs stay reserved from pick() until
+// install(), so jobs over disjoint files run side by side.
+struct CompactionJob {
+    size_t level = 0;
+    size_t outputLevel = 1;         // level + 1, except for pickL0()
+    double score = 0;               // score of `level` when picked
+
+    std::vector<SSTable> upper;     // from level, newest first
+    std::vector<SSTable> lower;     // overlapping files of outputLevel
+
+    // Key range of all inputs (and so of the outputs)
+    std::string smallest;
+    std::string largest;
+
+    // Key ranges of deeper files overlapping the inputs (sorted,
+    // merged); tombstones inside them must survive
+    std::vector<KeyRange> olderData;
+
+    // Nothing older overlaps the inputs: every tombstone no snapshot
+    // needs is dropped
+    bool bottommost = false;
+
+    // Picked for its tombstone ratio rather than its level's score
+    bool tombstoneTriggered = false;
+
+    // No file of level + 1 overlaps: the input changes level as is
+    bool trivialMove = false;
+
+    // Written by execute()
+    std::vector<SSTable> outputs;   // in key order, non-overlapping
+    uint64_t bytesWritten = 0;
+    size_t subcompactions = 1;
+};
+
+
+// Handles SSTable merging and cleanup.
+// pick(), install(), release() and isCompacting() read and change the
+// reservation state; callers serialize them with the lock that guards
+// `levels`. execute() needs no lock.
 class Compaction{
 public:
     enum class Strategy{
@@ -13,6 +60,15 @@ public:
         TIERED
     };
 
+    // Order in which the files of L1+ are tried by pick() (L0 always
+    // gives up its oldest file)
+    enum class Priority{
+        MIN_OVERLAPPING_RATIO,  // fewest next-level bytes per byte moved down
+        OLDEST_SMALLEST_SEQ,    // data that has waited longest goes first
+        ROUND_ROBIN,            // a cursor per level walks the key space
+        TOMBSTONE_DENSITY       // most deletions per entry first
+    };
+
 
    
 
@@ -21,15 +77,89 @@ public:
     void setStrategy(Strategy s);
 Strategy getStrategy() const;
 
+    // Files of L1+ whose tombstone ratio reaches `ratio` are compacted
+    // even when their level is within budget (0 disables)
+    void setTombstoneRatioTrigger(double ratio) { tombstoneRatioTrigger = ratio; }
 
-    // Run compaction on current SSTables, returns bytes written
-    
-    uint64_t run(std::vector<std::vector<SSTable>>& levels);
+    void setPriority(Priority p) { priority = p; }
+    Priority getPriority() const { return priority; }
+
+    // "min_overlapping_ratio", "oldest_smallest_seq", "round_robin",
+    // "tombstone_density"; false if `name` is none of them
+    static bool parsePriority(const std::string& name, Priority& p);
+
+    // Per-level byte counters and latency go here (optional)
+    void setStatistics(Statistics* stats) { this->stats = stats; }
+
+    // Compaction reads and writes are charged at LOW priority (optional)
+    void setRateLimiter(RateLimiter* limiter) { rateLimiter = limiter; }
+
+    // Upper bound on the key-range slices one job is split into; each
+    // slice gets at least MIN_SUBCOMPACTION_BYTES of input
+    void setMaxSubcompactions(size_t n) { maxSubcompactions = std::max<size_t>(1, n); }
+
+    // Highest-scoring level (score >= 1) with a file that can be
+    // compacted without touching a reserved file or a key range another
+    // job is writing, trying files in priority order; failing that, a
+    // file over the tombstone ratio trigger; nullptr if there is none
+    std::unique_ptr<CompactionJob> pick(const std::vector<std::vector<SSTable>>& levels,
+                                        const std::vector<double>& scores);
+
+    // All of L0 in one job, merged into the deepest level that no file
+    // between L0 and it overlaps; nullptr if L0 is empty or a file
+    // involved is reserved. Ends a bulk load.
+    std::unique_ptr<CompactionJob> pickL0(const std::vector<std::vector<SSTable>>& levels);
+
+    // Merges the inputs into job.outputs, one thread and one output file
+    // per key-range slice. Versions still visible to one of `snapshots`
+    // survive the merge.
+    void execute(CompactionJob& job,
+                 const std::vector<SequenceNumber>& snapshots = {});
+
+    // Replaces the inputs with the outputs, deletes the input files and
+    // ends the reservation
+    void install(std::vector<std::vector<SSTable>>& levels,
+                 const CompactionJob& job);
+
+    // Compacts the first file of the first non-empty level in the
+    // calling thread; returns bytes written
+    uint64_t run(std::vector<std::vector<SSTable>>& levels,
+                 const std::vector<SequenceNumber>& snapshots = {});
+
+    // Ends the reservation of a job that will not be installed
+    void release(const CompactionJob& job);
+
+    bool isCompacting(const std::string& filePath) const {
+        return reserved.count(filePath) != 0;
+    }
+
+    // Jobs picked and not yet installed or released
+    size_t runningCount() const { return inFlight.size(); }
 
 
 private:
-static constexpr size_t L0_THRESHOLD = 3;
+    static constexpr uint64_t MIN_SUBCOMPACTION_BYTES = 1ULL << 20;
+
+    // A handful of deletes in a small file is not worth a compaction
+    static constexpr uint64_t MIN_TRIGGER_TOMBSTONES = 32;
+
+    // Job for levels[level][index] and what it overlaps below, reserved;
+    // nullptr if an input is reserved or its range is being written
+    std::unique_ptr<CompactionJob> tryPick(const std::vector<std::vector<SSTable>>& levels,
+                                           size_t level, size_t index, double score);
+
+    // Keys that split the job's input into up to maxSubcompactions
+    // slices of similar size; empty for a single slice
+    std::vector<std::string> subcompactionBoundaries(const CompactionJob& job,
+                                                     uint64_t inputBytes) const;
 
+    bool conflicts(size_t outputLevel,
+                   const std::string& smallest,
+                   const std::string& largest) const;
+
+    // Indexes of levels[level] in the order pick() tries them
+    std::vector<size_t> candidateOrder(const std::vector<std::vector<SSTable>>& levels,
+                                       size_t level) const;
 
     
 
@@ -37,6 +167,17 @@ private:
 
     Strategy strategy;
     int maxFilesPerLevel;
+    Statistics* stats = nullptr;
+    RateLimiter* rateLimiter = nullptr;
+    size_t maxSubcompactions = 1;
+    Priority priority = Priority::MIN_OVERLAPPING_RATIO;
+    double tombstoneRatioTrigger = 0;
+
+    // ROUND_ROBIN: largest key of the last file picked, per level
+    std::vector<std::string> cursors;
+
+    std::set<std::string> reserved;             // input file paths
+    std::vector<const CompactionJob*> inFlight;
 };
 
 #endif
@@ -0,0 +1,74 @@
+#ifndef COMPACTION_ITERATOR_H
+#define COMPACTION_ITERATOR_H
+
+#include <vector>
+#include <string>
+
+#include "Iterator.h"
+#include "RangeTombstone.h"
+
+// Inclusive user-key range
+struct KeyRange {
+    std::string smallest;
+    std::string largest;
+};
+
+// Filters an all-versions stream (key ascending, newest first within a
+// key) down to the versions some reader can still observe.
+//
+// Live snapshots split the sequence space into stripes; a reader at
+// snapshot s sees the newest version with seq <= s, so only the newest
+// version inside each stripe is kept. Tombstones in the oldest stripe
+// hide nothing any reader needs and are dropped when dropTombstones
+// is set (compaction), but kept on flush to mask older SSTables.
+// Even then, a tombstone inside `olderData` (ranges of deeper files the
+// compaction does not read) is kept: it still masks an older version.
+// Entries covered by a range tombstone from the same stripe are dropped.
+class CompactionIterator : public Iterator {
+public:
+
+    CompactionIterator(Iterator& input,
+                       std::vector<SequenceNumber> snapshots,
+                       bool dropTombstones,
+                       const FragmentedRangeTombstoneList* rangeDels = nullptr,
+                       const std::vector<KeyRange>* olderData = nullptr);
+
+    bool valid() const override;
+    void next() override;
+
+    Slice key() const override;
+    Slice value() const override;
+    SequenceNumber sequence() const override;
+
+    // Versions removed so far (shadowed, range-deleted or elided tombstones)
+    uint64_t droppedEntries() const { return dropped; }
+
+    // The input range tombstones reduced the same way: newest per stripe,
+    // oldest stripe dropped when dropTombstones is set
+    FragmentedRangeTombstoneList outputRangeTombstones() const;
+
+private:
+
+    void findNext();
+
+    // Index of the smallest snapshot >= seq (snapshots.size() if none)
+    size_t stripeOf(SequenceNumber seq) const;
+
+    // Whether older data may hold `key`, or a key in [start, end)
+    bool olderDataHas(const Slice& key) const;
+    bool olderDataOverlaps(const std::string& start, const std::string& end) const;
+
+    Iterator& input;
+    std::vector<SequenceNumber> snapshots;   // ascending
+    bool dropTombstones;
+    const FragmentedRangeTombstoneList* rangeDels;
+    const std::vector<KeyRange>* olderData;  // sorted, disjoint
+
+    std::string currentKey;                  // reused buffer
+    bool hasCurrentKey = false;
+    size_t lastStripe = 0;
+
+    uint64_t dropped = 0;
+};
+
+#endif
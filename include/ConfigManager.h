@@ -2,6 +2,10 @@
 #define CONFIG_MANAGER_H
 
 #include <string>
+#include <cstdint>
+
+#include "WriteController.h"
+#include "RateLimiter.h"
 
 class ConfigManager{
 public:
@@ -12,7 +16,11 @@ public:
 
 
     // Getters
-    int getMemTableMaxEntries() const;
+    // MemTable size at which it is flushed (storage.memtable.max_bytes)
+    size_t getMemTableMaxBytes() const;
+
+    // Budget for all MemTables of all stores in the process (0: none)
+    size_t getWriteBufferManagerBytes() const;
     int getBloomFilterBitSize() const;
     int getBloomFilterHashCount() const;
     int getMaxFilesPerLevel() const;
@@ -22,13 +30,53 @@ public:
     int getL0Threshold() const;
     int getFlushInterval() const;
 
+    // Background pool sizes (HIGH: flush, LOW: compaction)
+    int getFlushThreads() const;
+    int getCompactionThreads() const;
+
+    // Key-range slices one compaction may be split into
+    int getMaxSubcompactions() const;
+
+    // Order in which compaction tries the files of a level
+    std::string getCompactionPriority() const;
+
+    // Tombstone share that makes a file due for compaction (0: off)
+    double getTombstoneRatioTrigger() const;
+
+    // LSM shape: level count (L0 included), L1 target size, growth per
+    // level, and whether targets follow the last level's actual size
+    int getNumLevels() const;
+    uint64_t getLevelBaseBytes() const;
+    double getLevelSizeMultiplier() const;
+    bool getDynamicLevelBytes() const;
+
+    // One memory budget for MemTables, caches and open tables (0: none).
+    // MemTables get write_buffer_manager.buffer_size (default: half),
+    // the caches what the rest leaves, split by row_cache_ratio
+    size_t getMemoryBudgetBytes() const;
+    double getRowCacheRatio() const;
+
+    // Bulk-load mode: open without a WAL, append-only MemTables of
+    // bulk_load.memtable_max_bytes sorted on sort_threads at flush,
+    // compaction deferred until KVStore::finishBulkLoad()
+    bool getBulkLoad() const;
+    size_t getBulkLoadMemTableMaxBytes() const;
+    int getBulkLoadSortThreads() const;
+
+    // Stall triggers; defaults scale with l0_threshold
+    const WriteControllerOptions& getWriteControllerOptions() const;
+
+    // Background I/O budget (off unless rate_limiter.bytes_per_second)
+    const RateLimiterOptions& getRateLimiterOptions() const;
+
 
     
 private:
     std::string configFilePath;
 
     // Stored configuration values
-    int memTableMaxEntries;
+    size_t memTableMaxBytes;
+    size_t writeBufferManagerBytes;
     int bloomFilterBitSize;
     int bloomFilterHashCount;
     int maxFilesPerLevel;
@@ -37,6 +85,27 @@ private:
     int compactionIntervalSeconds;
     int l0Threshold;
     int flushIntervalSeconds;
+
+    int flushThreads;
+    int compactionThreads;
+    int maxSubcompactions;
+    std::string compactionPriority;
+    double tombstoneRatioTrigger;
+
+    int numLevels;
+    uint64_t levelBaseBytes;
+    double levelSizeMultiplier;
+    bool dynamicLevelBytes;
+
+    size_t memoryBudgetBytes;
+    double rowCacheRatio;
+
+    bool bulkLoad;
+    size_t bulkLoadMemTableMaxBytes;
+    int bulkLoadSortThreads;
+
+    WriteControllerOptions writeControllerOptions;
+    RateLimiterOptions rateLimiterOptions;
 };
 
 #endif
\ No newline at end of file
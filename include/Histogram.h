@@ -0,0 +1,61 @@
+#ifndef HISTOGRAM_H
+#define HISTOGRAM_H
+
+#include <atomic>
+#include <vector>
+#include <string>
+#include <cstdint>
+#include <cstddef>
+
+// Point-in-time copy of a Histogram; cheap to merge and query
+struct HistogramSnapshot {
+    std::vector<uint64_t> counts;
+    uint64_t count = 0;
+    uint64_t sum = 0;
+    uint64_t min = 0;
+    uint64_t max = 0;
+
+    void merge(const HistogramSnapshot& other);
+
+    // What was recorded after `earlier` (a snapshot of the same
+    // histogram). min/max are bucket bounds, not exact values.
+    HistogramSnapshot since(const HistogramSnapshot& earlier) const;
+
+    // Value at percentile p (0..100), as the upper bound of its bucket
+    uint64_t percentile(double p) const;
+
+    double mean() const { return count ? static_cast<double>(sum) / count : 0.0; }
+};
+
+// Log-linear histogram of non-negative values (latencies in ns, sizes
+// in bytes). Exact below 64, within ~3% above. record() is lock-free
+// and safe from any number of threads.
+class Histogram {
+public:
+    // 64 exact buckets, then 32 per power of two up to 2^63
+    static constexpr size_t BUCKETS = 64 + 58 * 32;
+
+    Histogram();
+
+    void record(uint64_t value);
+
+    // Folds in previously recorded values (e.g. loaded from disk)
+    void add(const HistogramSnapshot& other);
+
+    HistogramSnapshot snapshot() const;
+
+    void reset();
+
+    static size_t bucketFor(uint64_t value);
+    static uint64_t bucketUpperBound(size_t bucket);
+    static uint64_t bucketLowerBound(size_t bucket);
+
+private:
+    std::atomic<uint64_t> counts[BUCKETS];
+    std::atomic<uint64_t> count;
+    std::atomic<uint64_t> sum;
+    std::atomic<uint64_t> min;
+    std::atomic<uint64_t> max;
+};
+
+#endif
@@ -0,0 +1,72 @@
+#ifndef INTERNAL_KEY_H
+#define INTERNAL_KEY_H
+
+#include <string>
+#include <cstdint>
+
+#include "Slice.h"
+
+// Every write is stamped with a 56-bit sequence number. On disk and in
+// the WAL it is packed with an 8-bit value type into one 64-bit tag.
+using SequenceNumber = uint64_t;
+
+static constexpr SequenceNumber MAX_SEQUENCE_NUMBER = (1ULL << 56) - 1;
+
+enum class ValueType : uint8_t {
+    DELETION = 0,
+    VALUE = 1
+};
+
+inline uint64_t packSequenceAndType(SequenceNumber seq, ValueType type) {
+    return ((seq & MAX_SEQUENCE_NUMBER) << 8) | static_cast<uint8_t>(type);
+}
+
+inline SequenceNumber tagSequence(uint64_t tag) {
+    return tag >> 8;
+}
+
+inline ValueType tagType(uint64_t tag) {
+    return static_cast<ValueType>(tag & 0xFF);
+}
+
+// User key plus version; ordered by key ascending, then newest first
+struct InternalKey {
+    std::string userKey;
+    SequenceNumber sequence;
+
+    InternalKey(const Slice& key, SequenceNumber seq)
+        : userKey(key.data(), key.size()), sequence(seq) {}
+};
+
+// Non-owning form used for lookups
+struct LookupKey {
+    Slice userKey;
+    SequenceNumber sequence;
+};
+
+struct InternalKeyComparator {
+    using is_transparent = void;
+
+    static int compare(const Slice& ak, SequenceNumber as,
+                       const Slice& bk, SequenceNumber bs) {
+        int cmp = ak.compare(bk);
+        if (cmp != 0) return cmp;
+        if (as > bs) return -1;   // higher sequence sorts first
+        if (as < bs) return 1;
+        return 0;
+    }
+
+    bool operator()(const InternalKey& a, const InternalKey& b) const {
+        return compare(a.userKey, a.sequence, b.userKey, b.sequence) < 0;
+    }
+
+    bool operator()(const InternalKey& a, const LookupKey& b) const {
+        return compare(a.userKey, a.sequence, b.userKey, b.sequence) < 0;
+    }
+
+    bool operator()(const LookupKey& a, const InternalKey& b) const {
+        return compare(a.userKey, a.sequence, b.userKey, b.sequence) < 0;
+    }
+};
+
+#endif
@@ -3,6 +3,9 @@
 
 #include <string>
 
+#include "Slice.h"
+#include "InternalKey.h"
+
 class Iterator{
 public:
 
@@ -11,8 +14,19 @@ public:
     virtual bool valid() const = 0;
     virtual void next() = 0;
 
-    virtual const std::string& key() const = 0;
-    virtual const std::string& value() const = 0;
+    // Slices stay valid until the next call to next()
+    virtual Slice key() const = 0;
+    virtual Slice value() const = 0;
+
+    // Version of the current entry (0 for pre-sequence files)
+    virtual SequenceNumber sequence() const = 0;
+
+    // Positions at the first entry with key >= target. This fallback
+    // only moves forward; iterators with an index override it.
+    virtual void seek(const Slice& target) {
+        while (valid() && key() < target)
+            next();
+    }
 };
 
 #endif
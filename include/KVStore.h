@@ -6,7 +6,12 @@
 #include <thread>
 #include <atomic>
 #include <mutex>
+#include <shared_mutex>
 #include <chrono>
+#include <memory>
+#include <set>
+#include <deque>
+#include <condition_variable>
 
 #include "ConfigManager.h"
 #include "MemTable.h"
@@ -17,31 +22,61 @@
 #include "LRUCache.h"
 #include "TableCache.h"
 #include "BlockCache.h"
+#include "PinnableSlice.h"
+#include "Snapshot.h"
+#include "Iterator.h"
+#include "Statistics.h"
+#include "PerfContext.h"
+#include "WriteController.h"
+#include "ThreadPool.h"
+#include "RateLimiter.h"
+#include "WriteBufferManager.h"
+
+
+// One row of the per-level stats table
+struct LevelStats {
+    size_t level = 0;
+    size_t files = 0;
+    uint64_t liveBytes = 0;             // files currently in the level
+    uint64_t flushBytes = 0;
+    uint64_t compactionReadUpper = 0;   // Rn: input from the level above
+    uint64_t compactionReadLower = 0;   // Rn+1: input from this level
+    uint64_t compactionWritten = 0;
+    uint64_t movedBytes = 0;            // trivial moves: received, not rewritten
+    uint64_t compactions = 0;
+    double compactionSeconds = 0;
+    uint64_t getTablesRead = 0;
+    uint64_t getBytesRead = 0;
+
+    // Bytes written into the level per byte it received from above
+    // (L0: per user byte written)
+    double writeAmp = 0;
+};
 
-const int MAX_LEVELS = 4;
-
-struct KVStats{
-    uint64_t totalReadSSTables = 0;
-
-    size_t totalPuts = 0;
-    size_t totalGets = 0;
-    size_t totalFlushes = 0;
-    size_t totalCompactions = 0;
-    size_t totalBytesWritten = 0;
-    size_t totalCompactionBytes = 0;
-
-    uint64_t bloomChecks = 0;
-    uint64_t bloomNegatives = 0;
-    uint64_t bloomFalsePositives = 0;
+// Bytes held in memory, by component (getApproximateMemoryUsage())
+struct MemoryUsage {
+    size_t memTables = 0;       // active and sealed MemTables
+    size_t rowCache = 0;        // LRUCache
+    size_t blockCache = 0;
+    size_t tableCache = 0;
+    size_t tableReaders = 0;    // blooms, indexes and range tombstones of live tables
+    size_t budget = 0;          // memory.budget_bytes; 0 = none
+
+    size_t total() const {
+        return memTables + rowCache + blockCache + tableCache + tableReaders;
+    }
+};
 
-    uint64_t cacheHits = 0;
-    uint64_t cacheMisses = 0;
+struct ReadOptions {
+    // Read as of this snapshot; nullptr reads the latest state
+    const Snapshot* snapshot = nullptr;
 
-    uint64_t benchmarkStartTime = 0;
-    uint64_t benchmarkEndTime = 0;
+    // Above DISABLED, get() resets the thread's PerfContext and fills it
+    // for this request; read it afterwards with getPerfContext()
+    PerfLevel perfLevel = PerfLevel::DISABLED;
 };
 
-class KVStore : public SSTableStatsHook {
+class KVStore : public SSTableStatsHook, public WriteBufferClient {
 public:
 
     explicit KVStore(const std::string& configPath,
@@ -51,11 +86,65 @@ public:
 
     void put(const std::string& key,const std::string& value);
     bool get(const std::string& key,std::string& value);
+
+    // Zero-copy get: `value` pins the cached block/row it references
+    bool get(const std::string& key, PinnableSlice& value);
+
+    // Copies into a caller-owned buffer (truncated to bufferSize).
+    // valueSize is always set to the full value length.
+    bool get(const std::string& key,
+             char* buffer,
+             size_t bufferSize,
+             size_t& valueSize);
     void deleteKey(const std::string& key);
 
+    // Deletes every key in [start, end) with one range tombstone.
+    // SSTables that lie entirely inside the range (and that no snapshot
+    // still reads) are deleted right away.
+    void deleteRange(const std::string& start, const std::string& end);
+
+    // Snapshot reads (bypass the row cache, which only holds latest values)
+    bool get(const ReadOptions& options,
+             const std::string& key,
+             std::string& value);
+
+    bool get(const ReadOptions& options,
+             const std::string& key,
+             PinnableSlice& value);
+
+    // Ordered iterator over live keys as of options.snapshot (or of the
+    // moment of the call). Tombstones are not returned.
+    std::unique_ptr<Iterator> newIterator(
+        const ReadOptions& options = ReadOptions());
+
+    // Pins the current state; compaction keeps every version it needs
+    const Snapshot* getSnapshot();
+    void releaseSnapshot(const Snapshot* snapshot);
+
+    SequenceNumber getLastSequence() const { return lastSequence.load(); }
+
     void setCompactionStrategy(const std::string& s);
 
+    // Seals the active MemTable and waits until it and every MemTable
+    // sealed before it are in L0
     void flush();
+
+    // Adds table files built offline (SSTableWriter) without rewriting
+    // them. Each is validated, moved into the SSTable directory and
+    // placed at the deepest level that neither it nor any level above
+    // overlaps. Their entries are newer than every earlier write. All
+    // files go in with one manifest edit; false, with nothing ingested,
+    // if a file is invalid or two of them overlap.
+    bool ingestFiles(const std::vector<std::string>& paths);
+
+    // Ends bulk-load mode (bulk_load.enabled in the config): flushes the
+    // last append-only MemTable, then merges all of L0 in one compaction
+    // into the deepest level it can reach and resumes normal compaction.
+    // Writes are logged to the WAL again from here on.
+    void finishBulkLoad();
+    bool isBulkLoading() const { return bulkLoading.load(); }
+
+
     void scan(const std::string& start,const std::string& end);
 
     void loadStats();
@@ -63,55 +152,197 @@ public:
 
     void printStats() const;
 
+    // Live counters and histograms; persisted to metadata/stats.dat
+    const Statistics& getStatistics() const { return stats; }
+
+    // SSTable bytes written (flush + compaction) per user byte written
+    double writeAmplification() const;
+
+    // SSTables searched per point lookup
+    double readAmplification() const;
+
+    // SSTable bytes on disk over the bytes in the largest level
+    double spaceAmplification() const;
+
+    // Current write throttling state (stall triggers in the config)
+    WriteCondition getWriteCondition() const { return writeController.getCondition(); }
+
+    // Background I/O budget shared by flushes (HIGH) and compactions (LOW)
+    RateLimiterStats getRateLimiterStats() const { return rateLimiter.getStats(); }
+
+    // HIGH pool: flushes; LOW pool: compactions
+    ThreadPoolStats getFlushPoolStats() const { return flushPool->getStats(); }
+    ThreadPoolStats getCompactionPoolStats() const { return compactionPool->getStats(); }
+
+    // Memory by component. With memory.budget_bytes set, the caches are
+    // resized to what MemTables and open tables leave of the budget,
+    // evicting as those grow
+    MemoryUsage getApproximateMemoryUsage() const;
+
+    // Level-by-level flush/compaction/read bytes and sizes
+    std::vector<LevelStats> getLevelStats() const;
+
+    // getLevelStats() as a LevelDB-style text table with a totals row
+    std::string getLevelStatsTable() const;
+
     // Bloom hooks
     void recordBloomCheck() override {
-        stats.bloomChecks++;
+        stats.recordTick(Ticker::BLOOM_CHECKS);
     }
 
     void recordBloomNegative() override {
-        stats.bloomNegatives++;
+        stats.recordTick(Ticker::BLOOM_NEGATIVES);
     }
 
     void recordBloomFalsePositive() override {
-        stats.bloomFalsePositives++;
+        stats.recordTick(Ticker::BLOOM_FALSE_POSITIVES);
     }
 
+    // Write buffer manager hooks
+    size_t activeMemTableBytes() const override;
+    void requestFlush() override;
+
 private:
 
+    // A full MemTable waiting for its flush job
+    struct ImmutableMemTable {
+        std::shared_ptr<MemTable> mem;
+        uint64_t id = 0;                    // sealing order
+        std::string filePath;               // SSTable it becomes
+        uint64_t fileNumber = 0;            // <n> of sstable_<n>.dat
+        std::vector<std::string> logs;      // WAL files deleted after the flush
+        bool claimed = false;               // a flush job has taken it
+    };
+
+    // Opens `path` for ingestion; false unless it is a v2 table whose
+    // keys are strictly increasing and match its key range
+    bool validateIngestedFile(const std::string& path, SSTable& table) const;
+
+    // Moves the active MemTable to the immutable list, starts a new WAL
+    // and schedules its flush (writeMutex held)
+    void sealMemTable();
+
+    // Flush job (HIGH pool): writes the oldest unclaimed immutable
+    // MemTable to an SSTable; L0 receives flushes in sealing order
     void flushMemTable();
+
     void loadFromManifest();
-    void runCompactionIfNeeded();
-    void backgroundFlush();
-    void backgroundCompaction();
+
+    // Picks as many compactions as there are free LOW pool threads
+    void maybeScheduleCompaction();
+
+    // Compaction job (LOW pool)
+    void backgroundCompaction(CompactionJob& job);
+
+    // Per level: L0 files over l0_threshold, else bytes over the level
+    // target; >= 1 needs compaction (levelsMutex held)
+    std::vector<double> levelScores() const;
+
     void sortSSTablesByAge();
 
+    // Active MemTable, then immutable ones newest first
+    std::vector<std::shared_ptr<MemTable>> memTables() const;
+
+    // Feeds the current tree shape to the write controller (and to the
+    // rate limiter's auto-tuning)
+    void updateWriteController();
+
+    // Adjusts the I/O budget from compaction debt and recent GET p99
+    void tuneRateLimiter(int l0Files, uint64_t pendingCompactionBytes);
+
+    // Bytes compaction must rewrite to bring every level under its
+    // target: all of L0 once it hits l0_threshold, plus each deeper
+    // level's excess (levelsMutex held)
+    uint64_t estimatePendingCompactionBytes() const;
+
+    std::shared_ptr<MemTable> activeMemTable() const;
+
+    // Gives the caches what MemTables and open tables leave of the
+    // memory budget, evicting down to it (no-op without a budget)
+    void rebalanceMemory();
+
+    // rebalanceMemory() once 1/64 of the budget has been written since
+    // the last time
+    void maybeRebalanceMemory(size_t bytesWritten);
+
+    // Empty MemTable for the current mode (append-only when bulk loading)
+    std::shared_ptr<MemTable> newMemTable() const;
+
+    // Merged view as of `snapshot`; SSTables outside [start, end] are
+    // skipped (empty end = unbounded)
+    std::unique_ptr<Iterator> newIterator(SequenceNumber snapshot,
+                                          const std::string& start,
+                                          const std::string& end);
+
+    // Sequence numbers of live snapshots, ascending
+    std::vector<SequenceNumber> liveSnapshots() const;
+
+    // Removes SSTables entirely inside [start, end) and older than seq
+    void dropFilesInRange(const std::string& start,
+                          const std::string& end,
+                          SequenceNumber seq);
+
     std::chrono::steady_clock::time_point lastCompactionTime;
 
     // stats
-    KVStats stats;
+    Statistics stats;
 
     ConfigManager configManager;
-    MemTable* memTable;
+
+    // Process-wide; budget from write_buffer_manager.buffer_size
+    WriteBufferManager& writeBufferManager;
+
+    // Swapped (not cleared) on flush so open iterators stay valid
+    std::shared_ptr<MemTable> memTable;
+    mutable std::mutex memTableMutex;   // guards the pointers and the list
     WAL wal;
 
+    // Oldest first; guarded by memTableMutex
+    std::deque<std::shared_ptr<ImmutableMemTable>> immutables;
+    uint64_t nextImmutableId = 0;
+    std::condition_variable flushInstalled;
+
+    // Sealed WAL files replayed into the active MemTable at startup
+    std::vector<std::string> recoveredLogs;
+
+    std::atomic<SequenceNumber> lastSequence;
+
+    std::multiset<SequenceNumber> snapshots;
+    mutable std::mutex snapshotMutex;
+
     std::vector<std::vector<SSTable>> levels;
+    mutable std::shared_mutex levelsMutex;
 
     Compaction compaction;
     ManifestManager manifest;
 
     int sstableCounter;
 
+    std::atomic<size_t> bytesSinceRebalance{0};
+
     // CACHE LAYER (FIXED ORDER)
     TableCache tableCache;
     LRUCache cache;          // moved before blockCache
     BlockCache blockCache;   // LAST
 
-    std::thread flushThread;
-    std::thread compactionThread;
-
     std::atomic<bool> running;
 
-    std::mutex flushMutex;
+    // Bulk load: no WAL, append-only MemTables; compaction stays
+    // deferred until finishBulkLoad() has picked its final job
+    std::atomic<bool> bulkLoading{false};
+    std::atomic<bool> compactionDeferred{false};
+
+    WriteController writeController;
+
+    RateLimiter rateLimiter;
+    std::mutex tuneMutex;
+    HistogramSnapshot lastGetLatency;   // guarded by tuneMutex
+
+    std::unique_ptr<ThreadPool> flushPool;
+    std::unique_ptr<ThreadPool> compactionPool;
+    size_t maxCompactions = 1;
+
+    std::mutex writeMutex;   // orders writers against MemTable swaps
 };
 
 #endif
\ No newline at end of file
@@ -3,6 +3,12 @@
 #include <unordered_map>
 #include <list>
 #include <string>
+#include <mutex>
+#include <atomic>
+#include <limits>
+#include <cstdint>
+
+#include "PinnableSlice.h"
 
 class LRUCache{
 
@@ -10,27 +16,68 @@ private:
 
     struct Node{
         std::string key;
-        std::string value;
+        PinnableSlice value;   // pins either its own copy or an SSTable block
     };
 
     size_t capacity;
 
+    // Memory limit on top of the entry limit (KVStore's memory budget)
+    std::atomic<size_t> capacityBytes{std::numeric_limits<size_t>::max()};
+    std::atomic<size_t> usage{0};
+
+    // Drops LRU entries until both limits hold (mtx held)
+    void evictLocked();
+
+    static size_t charge(const Node& node);
+
+    // Inserts or refreshes `key` (mtx held)
+    void putLocked(const std::string& key, const PinnableSlice& value);
+
     std::list<Node> cacheList;
 
     std::unordered_map<std::string, std::list<Node>::iterator> cacheMap;
 
-public:
+    std::mutex mtx;
+
+    std::atomic<size_t> hits{0};
+    std::atomic<size_t> misses{0};
 
-    size_t hits = 0;
-    size_t misses = 0;
+public:
 
     LRUCache(size_t cap);
 
     bool get(const std::string& key, std::string& value);
+    bool get(const std::string& key, PinnableSlice& value);
 
     void put(const std::string& key, const std::string& value);
+    void put(const std::string& key, const PinnableSlice& value);
+
+    // Read-path fill: inserts only if `lastSequence` still equals
+    // `seqAtLookupStart` (checked under the cache mutex). Writers publish
+    // lastSequence before touching the cache, so a fill racing a write
+    // is skipped instead of caching the overwritten value
+    bool putIfUnchanged(const std::string& key, const PinnableSlice& value,
+                        uint64_t seqAtLookupStart,
+                        const std::atomic<uint64_t>& lastSequence);
 
 
 void remove(const std::string& key);
 
-};
\ No newline at end of file
+    // Drops every entry with start <= key < end (linear in cache size)
+    void removeRange(const std::string& start, const std::string& end);
+
+    // Entry limit; evicts down to it right away if over it
+    void setCapacity(size_t entries);
+
+    // Evicts down to `bytes` right away if over it
+    void setCapacityBytes(size_t bytes);
+    size_t getCapacityBytes() const { return capacityBytes.load(); }
+
+    // Keys, pinned value buffers (an SSTable block for values read from
+    // disk) and per-entry list and hash-map nodes
+    size_t getUsage() const { return usage.load(); }
+
+    size_t getHits() const { return hits.load(); }
+    size_t getMisses() const { return misses.load(); }
+
+};
@@ -4,6 +4,11 @@
 #include <string>
 #include <vector>
 #include <cstdint>
+#include <fstream>
+#include <mutex>
+#include <utility>
+
+#include "InternalKey.h"
 
 // Metadata for each SSTable
 struct SSTableMeta {
@@ -11,27 +16,86 @@ struct SSTableMeta {
     std::string minKey;
     std::string maxKey;
     std::uint64_t fileSize;
+    SequenceNumber globalSeq = 0;   // ingested files (SSTable::setGlobalSequence)
 
     SSTableMeta() = default;
 
     SSTableMeta(const std::string& path,
                  const std::string& minK,
                  const std::string& maxK,
-                 std::uint64_t size)
+                 std::uint64_t size,
+                 SequenceNumber globalSeq = 0)
         : filePath(path),
           minKey(minK),
           maxKey(maxK),
-          fileSize(size) {}
+          fileSize(size),
+          globalSeq(globalSeq) {}
 };
 
-// Manages metadata required for recovery
+// One atomic change to the set of live SSTables (a flush, a compaction,
+// a range delete dropping files). A snapshot is the edit that adds
+// every live file to an empty tree.
+struct VersionEdit {
+    std::vector<std::pair<int, SSTableMeta>> added;     // (level, file)
+    std::vector<std::pair<int, std::string>> removed;   // (level, path)
+
+    bool hasNextFileNumber = false;
+    std::uint64_t nextFileNumber = 0;
+
+    bool hasLastSequence = false;
+    SequenceNumber lastSequence = 0;
+
+    void addFile(int level, const SSTableMeta& meta) { added.emplace_back(level, meta); }
+    void removeFile(int level, const std::string& path) { removed.emplace_back(level, path); }
+
+    void setNextFileNumber(std::uint64_t n) { hasNextFileNumber = true; nextFileNumber = n; }
+    void setLastSequence(SequenceNumber s) { hasLastSequence = true; lastSequence = s; }
+
+    bool empty() const {
+        return added.empty() && removed.empty() && !hasNextFileNumber && !hasLastSequence;
+    }
+
+    // Tagged fields: {u8 tag, fields}*; strings are [u32 len][bytes]
+    void encodeTo(std::string& out) const;
+    static bool decodeFrom(const char* p, size_t n, VersionEdit& edit);
+};
+
+// Manages metadata required for recovery.
+// The manifest is a binary, append-only log of VersionEdits, each framed
+// as [u32 length][u32 crc32][edit]. It starts with a snapshot of the
+// tree; once the edits after it outgrow the snapshot, the current state
+// is written to a new log that replaces the old one.
 class ManifestManager {
 
 public:
-    explicit ManifestManager(const std::string& manifestPath);
+    // `legacyTextPath`: pipe-delimited manifest of older versions,
+    // migrated on load() if no log exists yet
+    explicit ManifestManager(const std::string& manifestPath,
+                             const std::string& legacyTextPath = "");
 
+    // Rebuilds the tree from the log (stopping at the first damaged
+    // record), then starts a fresh log from the result
     void load();
-    void save() const;
+
+    // Level shape; call before load(). Static targets are
+    // base * multiplier^(level - 1) for L1+. Dynamic targets derive from
+    // the last level's actual size: each level above holds 1/multiplier
+    // of the one below, down to the first level whose target would drop
+    // under `baseBytes` (the base level); levels above it target 0 and
+    // drain into it.
+    void setLevelOptions(int numLevels,
+                         std::uint64_t baseBytes,
+                         double multiplier,
+                         bool dynamic);
+
+    // Configured level count, or more if the log holds deeper files
+    int getNumLevels() const;
+
+    // Writes the current state as a new snapshot log
+    void save();
+
+    // Applies `edit` and appends it to the log
+    void logAndApply(const VersionEdit& edit);
 
     bool levelOverflow(int level) const;
 
@@ -41,23 +105,66 @@ public:
 
     void removeSSTable(const std::string& filePath);
 
+    // Target size of `level` (0: above the dynamic base level)
     std::uint64_t levelMaxBytes(int level) const;
     std::uint64_t levelBytesUsed(int level) const;
 
     std::size_t levelFileCount(int level) const;
 
+    // Not synchronized; read it before changes start (startup)
     const std::vector<std::vector<SSTableMeta>>& getLevels() const;
 
+    std::uint64_t getNextFileNumber() const;
+    SequenceNumber getLastSequence() const;
+
+    // In memory only; save() persists the empty tree
     void clear();
 
 private:
+    // Roll once the log is this many times the snapshot it started with
+    // (and at least MIN_ROLL_BYTES)
+    static constexpr std::uint64_t ROLL_FACTOR = 4;
+    static constexpr std::uint64_t MIN_ROLL_BYTES = 64 * 1024;
+
+    static constexpr int DEFAULT_NUM_LEVELS = 4;
+
+    // levelOverflow(0): L0 is judged by file count
+    static constexpr std::size_t L0_OVERFLOW_FILES = 4;
+
+    std::uint64_t levelMaxBytesLocked(int level) const;
+
+    void apply(const VersionEdit& edit);
+
+    // Current state as a single edit
+    VersionEdit snapshot() const;
+
+    void writeSnapshotLocked();
+    bool appendRecord(std::ofstream& out, const VersionEdit& edit);
+
+    bool loadLegacyText();
+
     std::string manifestPath;
+    std::string legacyTextPath;
+
+    mutable std::mutex mtx;
 
     // FULL metadata per level
     std::vector<std::vector<SSTableMeta>> levels;
 
     // Level size tracking
     std::vector<std::uint64_t> levelBytes;
+
+    std::uint64_t nextFileNumber = 0;
+    SequenceNumber lastSequence = 0;
+
+    int numLevels = DEFAULT_NUM_LEVELS;
+    std::uint64_t baseBytes = 100ULL * 1024ULL * 1024ULL;   // L1
+    double multiplier = 10.0;
+    bool dynamicLevelBytes = false;
+
+    std::ofstream log;
+    std::uint64_t logBytes = 0;
+    std::uint64_t snapshotBytes = 0;
 };
 
 #endif
@@ -2,32 +2,116 @@
 #define MEMTABLE_H
 
 #include<string>
-#include<map>
 #include<mutex>
+#include<functional>
+#include<memory>
+#include<vector>
+#include<utility>
+#include<atomic>
+
+#include "Slice.h"
+#include "InternalKey.h"
+#include "SkipList.h"
+#include "RangeTombstone.h"
+#include "WriteBufferManager.h"
+
 static constexpr const char* TOMBSTONE = "__AURORA_TOMBSTONE__";
 
+// Entries of an append-only MemTable; in InternalKey order once sorted
+using MemTableVector = std::vector<std::pair<InternalKey, std::string>>;
+
 class MemTable{
 public:
-    explicit MemTable(int maxEntries);
+    // Full once getMemoryUsage() reaches maxBytes. Append-only (bulk
+    // load): puts go to the end of a vector and are only ordered by
+    // sortEntries(); lookups before that scan it.
+    explicit MemTable(size_t maxBytes,
+                      bool appendOnly = false,
+                      WriteBufferManager* writeBufferManager = nullptr);
+
+    ~MemTable();
+
+    MemTable(const MemTable&) = delete;
+    MemTable& operator=(const MemTable&) = delete;
+
+    void put(const Slice& key, const Slice& value, SequenceNumber seq);
+
+    // Newest version of `key` with sequence <= snapshot.
+    // A deleted key is found with value TOMBSTONE; `seq` (optional)
+    // receives the version's sequence. Range tombstones are not applied.
+    // Lock-free unless append-only.
+    bool get(const Slice& key,
+             std::string& value,
+             SequenceNumber snapshot = MAX_SEQUENCE_NUMBER,
+             SequenceNumber* seq = nullptr) const;
+
+    void remove(const Slice& key, SequenceNumber seq);
+
+    // Deletes [start, end) as of seq. Kept unfragmented here; flush
+    // fragments them into the SSTable's range tombstone block.
+    void addRangeTombstone(const Slice& start,
+                           const Slice& end,
+                           SequenceNumber seq);
+
+    // Newest range tombstone covering `key` visible at `snapshot`, or 0
+    SequenceNumber maxCoveringTombstone(const Slice& key,
+                                        SequenceNumber snapshot) const;
 
-    void put(const std::string& key, const std::string& value);
-    bool get(const std::string& key, std::string& value) const;
-    void remove(const std::string& key);
+    std::vector<RangeTombstone> getRangeTombstones() const;
     static const std::string TOMBSTONE;
 
     bool isFull() const;
      bool isEmpty() const;
+
+    // Not while anything still reads getData()
     void clear();
 
-    const std::map<std::string, std::string>& getData() const;
+    // Bytes allocated for entries: keys and values, their skiplist
+    // nodes (or vector slots) and allocator headers
+    size_t getMemoryUsage() const { return memoryUsage.load(); }
+
+    // No more writes; its memory stops counting as mutable in the
+    // write buffer manager
+    void markImmutable();
+
+    // All versions of every key, newest first within a key (empty when
+    // append-only). Safe to read while writes go on; a reader filters
+    // out versions newer than its snapshot.
+    const SkipList& getData() const;
+
+    bool isAppendOnly() const { return appendOnly; }
+
+    // Sorts an append-only MemTable on up to `threads` threads; once
+    // done no more writes may arrive and getSortedEntries() is valid
+    void sortEntries(size_t threads);
+    const MemTableVector& getSortedEntries() const;
+
+    // Ordered copy of the entries with start <= key <= end (empty end:
+    // unbounded), taken under the lock. For append-only MemTables, whose
+    // vector can't be read while written or sorted; costs a copy of
+    // every entry in range.
+    std::shared_ptr<const SkipList> snapshotData(const std::string& start,
+                                                 const std::string& end) const;
 
    
 
 
 private:
     mutable std::mutex mtx;
-    std::map<std::string, std::string> table;
-    int maxEntries;
+    SkipList table;
+    std::vector<RangeTombstone> rangeTombstones;
+    size_t maxBytes;
+
+    // Adds to memoryUsage and to the write buffer manager (mtx held)
+    void charge(size_t bytes);
+
+    std::atomic<size_t> memoryUsage{0};
+    WriteBufferManager* writeBufferManager;
+    bool immutable = false;
+
+    bool appendOnly = false;
+    bool sorted = false;
+    MemTableVector entries;     // append-only mode
 };
 
 #endif
@@ -2,37 +2,89 @@
 #define MEMTABLE_ITERATOR_H
 
 #include "Iterator.h"
-#include <map>
+#include "MemTable.h"
+
+#include <algorithm>
 
 class MemTableIterator : public Iterator{
 
 public:
 
-    using MapIter = std::map<std::string, std::string>::const_iterator;
+    // Reads the list in place, also while it takes writes; versions
+    // inserted meanwhile show up and are left to the snapshot filter
+    explicit MemTableIterator(const SkipList& list)
+        : list(list), node(list.first()) {}
 
-    MemTableIterator(MapIter begin, MapIter end)
-        : it(begin), endIt(end) {}
+    bool valid() const override{
+        return node != nullptr;
+    }
+
+    void next() override{
+        if (node) node = node->next(0);
+    }
+
+    Slice key() const override{
+        return node->key.userKey;
+    }
+
+    Slice value() const override {
+        return node->value;
+    }
+
+    SequenceNumber sequence() const override {
+        return node->key.sequence;
+    }
+
+    void seek(const Slice& target) override {
+        // Newest version of the first key >= target
+        node = list.lowerBound(LookupKey{target, MAX_SEQUENCE_NUMBER});
+    }
+
+private:
+    const SkipList& list;
+    const SkipList::Node* node;
+};
+
+// Cursor over the sorted entries of an append-only MemTable
+class MemTableVectorIterator : public Iterator{
+
+public:
+
+    explicit MemTableVectorIterator(const MemTableVector& entries)
+        : entries(entries), pos(0) {}
 
     bool valid() const override{
-        return it != endIt;
+        return pos < entries.size();
     }
 
     void next() override{
-        if (it != endIt) ++it;
+        if (pos < entries.size()) ++pos;
+    }
+
+    Slice key() const override{
+        return entries[pos].first.userKey;
+    }
+
+    Slice value() const override {
+        return entries[pos].second;
     }
 
-    const std::string& key() const override{
-        return it->first;
+    SequenceNumber sequence() const override {
+        return entries[pos].first.sequence;
     }
 
-    const std::string& value() const override {
-        return it->second;
+    void seek(const Slice& target) override {
+        const LookupKey k{target, MAX_SEQUENCE_NUMBER};
+        pos = static_cast<size_t>(
+            std::lower_bound(entries.begin(), entries.end(), k,
+                             [](const MemTableVector::value_type& e, const LookupKey& key) {
+                                 return InternalKeyComparator()(e.first, key);
+                             }) - entries.begin());
     }
 
-    
 private:
-    MapIter it;
-    MapIter endIt;
+    const MemTableVector& entries;
+    size_t pos;
 };
 
 #endif
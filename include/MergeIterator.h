@@ -4,43 +4,65 @@
 
 #include "Iterator.h"
 #include <vector>
-#include <queue>
+#include <string>
 
+// K-way merge over sorted inputs using a tournament (loser) tree.
+// Each internal node remembers the loser of its match, so replacing the
+// winner costs one key comparison per tree level. Equal keys are ordered
+// by sequence number (newest first), then by input index (lower = newer
+// source) for files written before sequence numbers existed.
+//
+// By default only the newest version of each key visible at `snapshot`
+// is emitted. With keepAllVersions every version is emitted in
+// (key, newest first) order, which is what compaction needs.
 class MergeIterator : public Iterator{
 
 public:
 
-    explicit MergeIterator(std::vector<Iterator*> inputs);
+    explicit MergeIterator(std::vector<Iterator*> inputs,
+                           SequenceNumber snapshot = MAX_SEQUENCE_NUMBER,
+                           bool keepAllVersions = false);
 
     bool valid() const override;
     void next() override;
 
-    const std::string& key() const override;
-    const std::string& value() const override;
+    // Forwarded from the winning input; no copy
+    Slice key() const override;
+    Slice value() const override;
+    SequenceNumber sequence() const override;
+
+    // Seeks every input and rebuilds the tree
+    void seek(const Slice& target) override;
 
 private:
 
-    struct Node{
-        Iterator* it;
-        size_t priority; // lower = higher priority (MemTable first)
-    };
+    // True if input a must be emitted before input b
+    bool beats(size_t a, size_t b) const;
+
+    // Re-run the matches on the path from leaf `child` to the root
+    void replay(size_t child);
+
+    // Refresh the cached key/sequence, skipping versions newer than
+    // the snapshot
+    void loadChild(size_t child);
+
+    // Move `child` forward and replay its path
+    void advanceChild(size_t child);
 
+    void build();
+    void skipDuplicates();
 
-    struct Compare{
-        bool operator()(const Node& a, const Node& b) const{
+    std::vector<Iterator*> children;   // index = priority (lower is newer)
+    std::vector<Slice> keys;            // cached child->key()
+    std::vector<SequenceNumber> seqs;   // cached child->sequence()
+    std::vector<bool> live;             // child still valid
 
-            if(a.it->key() != b.it->key())
-                return a.it->key() > b.it->key(); // min-heap
-            return a.priority > b.priority;
-        }
-    };
+    std::vector<size_t> tree;           // tree[0] = winner, rest = losers
 
-    
-    void advance();
+    SequenceNumber snapshot;
+    bool keepAllVersions;
 
-    std::priority_queue<Node, std::vector<Node>, Compare> heap;
-    std::string curKey;
-    std::string curValue;
+    std::string lastKey;                // reused buffer, no per-record alloc
     bool isValid = false;
 };
 
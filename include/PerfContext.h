@@ -0,0 +1,99 @@
+#ifndef PERF_CONTEXT_H
+#define PERF_CONTEXT_H
+
+#include <string>
+#include <chrono>
+#include <cstdint>
+
+// How much a read records into the calling thread's PerfContext
+enum class PerfLevel : uint8_t {
+    DISABLED = 0,   // nothing recorded (default)
+    COUNT = 1,      // counters only
+    TIME = 2        // counters and nanoseconds per stage
+};
+
+// Where one operation spent its time, per thread. Enable it for a read
+// with ReadOptions::perfLevel (or for a span of calls with
+// PerfLevelScope) and read getPerfContext() afterwards.
+struct PerfContext {
+    // Stage timings (PerfLevel::TIME)
+    uint64_t getNanos = 0;            // whole KVStore::get
+    uint64_t rowCacheNanos = 0;
+    uint64_t memtableNanos = 0;
+    uint64_t bloomNanos = 0;
+    uint64_t indexNanos = 0;          // sparse index search
+    uint64_t blockReadNanos = 0;      // block cache lookup + file I/O
+    uint64_t blockDecodeNanos = 0;    // record search inside blocks
+
+    // Counters
+    uint64_t rowCacheHits = 0;
+    uint64_t rowCacheMisses = 0;
+    uint64_t memtableHits = 0;
+    uint64_t sstablesTouched = 0;     // key in range, bloom consulted
+    uint64_t bloomProbes = 0;
+    uint64_t bloomHits = 0;           // filter said "maybe"
+    uint64_t blockCacheHits = 0;
+    uint64_t blockCacheMisses = 0;
+    uint64_t blocksRead = 0;          // read from disk
+    uint64_t bytesRead = 0;
+
+    void reset() { *this = PerfContext(); }
+
+    // "name = value" for every non-zero field
+    std::string toString() const;
+};
+
+inline thread_local PerfLevel tlsPerfLevel = PerfLevel::DISABLED;
+inline thread_local PerfContext tlsPerfContext;
+
+inline PerfContext& getPerfContext() { return tlsPerfContext; }
+
+// Sets the thread's level for a scope and restores the old one
+class PerfLevelScope {
+public:
+    explicit PerfLevelScope(PerfLevel level) : saved(tlsPerfLevel) { tlsPerfLevel = level; }
+    ~PerfLevelScope() { tlsPerfLevel = saved; }
+
+    PerfLevelScope(const PerfLevelScope&) = delete;
+    PerfLevelScope& operator=(const PerfLevelScope&) = delete;
+
+private:
+    PerfLevel saved;
+};
+
+// Adds the scope's duration to one PerfContext field; reads the clock
+// only at PerfLevel::TIME
+class PerfTimer {
+public:
+    explicit PerfTimer(uint64_t PerfContext::*field)
+        : field(tlsPerfLevel >= PerfLevel::TIME ? field : nullptr) {
+        if (this->field) start = std::chrono::steady_clock::now();
+    }
+
+    ~PerfTimer() { stop(); }
+
+    // Ends the measurement early
+    void stop() {
+        if (!field) return;
+        tlsPerfContext.*field += std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now() - start).count();
+        field = nullptr;
+    }
+
+    PerfTimer(const PerfTimer&) = delete;
+    PerfTimer& operator=(const PerfTimer&) = delete;
+
+private:
+    uint64_t PerfContext::*field;
+    std::chrono::steady_clock::time_point start;
+};
+
+#define PERF_COUNTER_ADD(field, n)                      \
+    do {                                                \
+        if (tlsPerfLevel != PerfLevel::DISABLED)        \
+            tlsPerfContext.field += (n);                \
+    } while (0)
+
+#define PERF_TIMER_GUARD(field) PerfTimer perfTimer_##field(&PerfContext::field)
+
+#endif
@@ -0,0 +1,50 @@
+#ifndef PINNABLE_SLICE_H
+#define PINNABLE_SLICE_H
+
+#include <string>
+#include <memory>
+#include <cstddef>
+
+#include "Slice.h"
+
+// Read result that references bytes owned by someone else (a cached
+// SSTable block, a row cache entry) instead of copying them.
+// The referenced buffer stays alive for as long as the slice holds its pin.
+class PinnableSlice : public Slice {
+public:
+    PinnableSlice() = default;
+
+    // Reference [d, d + n) inside a buffer kept alive by `buffer`
+    void pinSlice(std::shared_ptr<const std::string> buffer,
+                  const char* d,
+                  size_t n) {
+        pin = std::move(buffer);
+        ptr = d;
+        len = n;
+    }
+
+    // Take ownership of a standalone value (MemTable hits, fresh puts)
+    void pinSelf(std::string value) {
+        auto owned = std::make_shared<const std::string>(std::move(value));
+        ptr = owned->data();
+        len = owned->size();
+        pin = std::move(owned);
+    }
+
+    // Drop the pin; the slice becomes empty
+    void reset() {
+        pin.reset();
+        ptr = "";
+        len = 0;
+    }
+
+    bool isPinned() const { return pin != nullptr; }
+
+    // Size of the buffer held alive by this slice (may exceed size())
+    size_t pinnedBytes() const { return pin ? pin->size() : 0; }
+
+private:
+    std::shared_ptr<const std::string> pin;
+};
+
+#endif
@@ -14,8 +14,12 @@ public:
     bool valid() const override;
     void next() override;
 
-    const std::string& key() const override;
-    const std::string& value() const override;
+    Slice key() const override;
+    Slice value() const override;
+    SequenceNumber sequence() const override;
+
+    // Clamped to the start of the range
+    void seek(const Slice& target) override;
 
     
 private:
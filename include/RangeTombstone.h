@@ -0,0 +1,79 @@
+#ifndef RANGE_TOMBSTONE_H
+#define RANGE_TOMBSTONE_H
+
+#include <string>
+#include <vector>
+#include <cstdint>
+
+#include "Slice.h"
+#include "InternalKey.h"
+
+// Deletes every key in [start, end) written before `seq`
+struct RangeTombstone {
+    std::string start;
+    std::string end;      // exclusive
+    SequenceNumber seq;
+};
+
+// Range tombstones split at every start/end boundary so that fragments
+// never overlap: each fragment lists the sequence numbers of all
+// tombstones covering it. A covering lookup is then one binary search
+// instead of a scan over every tombstone.
+//
+// This is also the on-disk form of an SSTable's "rangedel" meta block:
+// [u32 count] { [u32 slen][start][u32 elen][end][u32 n][u64 seq]*n }
+class FragmentedRangeTombstoneList {
+public:
+
+    struct Fragment {
+        std::string start;
+        std::string end;                    // exclusive
+        std::vector<SequenceNumber> seqs;   // newest first
+    };
+
+    FragmentedRangeTombstoneList() = default;
+
+    explicit FragmentedRangeTombstoneList(
+        const std::vector<RangeTombstone>& tombstones);
+
+    bool empty() const { return fragments.empty(); }
+    size_t size() const { return fragments.size(); }
+
+    const std::vector<Fragment>& getFragments() const { return fragments; }
+
+    // Newest tombstone covering `key` that is visible at `snapshot`,
+    // or 0 if none
+    SequenceNumber maxCoveringSeq(const Slice& key,
+                                  SequenceNumber snapshot) const;
+
+    // Oldest tombstone covering `key` that is newer than `seq`, or 0
+    SequenceNumber nextCoveringSeq(const Slice& key, SequenceNumber seq) const;
+
+    // True if every key in [first, last] (both inclusive) is covered by
+    // some tombstone newer than `seq` and visible at `snapshot`
+    bool coversRange(const Slice& first,
+                     const Slice& last,
+                     SequenceNumber seq,
+                     SequenceNumber snapshot = MAX_SEQUENCE_NUMBER) const;
+
+    // Smallest / largest key touched by any fragment
+    const std::string& smallestKey() const;
+    const std::string& largestKey() const;
+
+    // Flat (start, end, seq) form, e.g. to merge several lists
+    void appendTo(std::vector<RangeTombstone>& out) const;
+
+    void encodeTo(std::string& out) const;
+    static bool decodeFrom(const char* p,
+                           size_t n,
+                           FragmentedRangeTombstoneList& out);
+
+private:
+
+    // Index of the fragment containing key, or size() if none
+    size_t findFragment(const Slice& key) const;
+
+    std::vector<Fragment> fragments;   // sorted by start, disjoint
+};
+
+#endif
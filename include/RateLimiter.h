@@ -0,0 +1,94 @@
+#ifndef RATE_LIMITER_H
+#define RATE_LIMITER_H
+
+#include <mutex>
+#include <condition_variable>
+#include <deque>
+#include <chrono>
+#include <cstdint>
+
+// Background I/O classes; HIGH requests are always served first
+enum class IOPriority {
+    HIGH,   // flush
+    LOW     // compaction
+};
+
+struct RateLimiterOptions {
+    // Background read + write budget; 0 turns the limiter off
+    uint64_t bytesPerSecond = 0;
+
+    // Raise the budget while compaction falls behind, lower it while
+    // foreground reads slow down, within [min, max]
+    bool autoTune = false;
+    uint64_t minBytesPerSecond = 4ULL << 20;
+    uint64_t maxBytesPerSecond = 512ULL << 20;
+};
+
+struct RateLimiterStats {
+    uint64_t bytesPerSecond = 0;
+    uint64_t bytes[2] = {0, 0};         // by IOPriority
+    uint64_t requests[2] = {0, 0};
+    uint64_t waitNanos[2] = {0, 0};
+};
+
+// Token bucket shared by flush and compaction SSTable I/O.
+// Tokens are bytes, refilled continuously up to REFILL_PERIOD worth of
+// budget; requests larger than that are served in pieces, and waiting
+// requests are granted strictly in priority then arrival order.
+class RateLimiter {
+public:
+    explicit RateLimiter(const RateLimiterOptions& options = {});
+
+    // Replaces the options; the budget restarts at bytesPerSecond
+    void setOptions(const RateLimiterOptions& options);
+
+    // Blocks until `bytes` may be read or written
+    void request(uint64_t bytes, IOPriority priority);
+
+    bool isEnabled() const;
+
+    uint64_t getBytesPerSecond() const;
+
+    // True when autoTune is on and a tuning interval has passed
+    bool tuneDue() const;
+
+    // debtRatio: compaction backlog relative to where writes start to
+    // slow down (1 = at the slowdown trigger); the budget grows from
+    // halfway there. readP99Nanos: GET p99 over the last interval
+    // (0 = no reads).
+    void tune(double debtRatio, uint64_t readP99Nanos);
+
+    RateLimiterStats getStats() const;
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    static constexpr std::chrono::milliseconds REFILL_PERIOD{100};
+    static constexpr std::chrono::seconds TUNE_INTERVAL{1};
+
+    // Adds the tokens earned since the last refill (mtx held)
+    void refill(Clock::time_point now);
+
+    uint64_t burstBytes() const;
+
+    // The waiter allowed to take tokens next (mtx held)
+    const void* nextWaiter() const;
+
+    RateLimiterOptions options;
+
+    mutable std::mutex mtx;
+    std::condition_variable granted;
+
+    uint64_t rate = 0;
+    double available = 0;
+    Clock::time_point lastRefill;
+
+    std::deque<const void*> queues[2];  // by IOPriority
+
+    Clock::time_point lastTune;
+    double baselineReadP99 = 0;
+
+    RateLimiterStats counters;
+};
+
+#endif
@@ -6,11 +6,62 @@
 #include <map>
 #include <cstdint>
 #include <fstream>
+#include <memory>
 
 #include "BloomFilter.h"
+#include "BlockCache.h"
+#include "PinnableSlice.h"
+#include "Slice.h"
+#include "Iterator.h"
+#include "InternalKey.h"
+#include "RangeTombstone.h"
+#include "RateLimiter.h"
 
+// v1: [u32 klen][key][u32 vlen][value] records, no versions
 static constexpr uint64_t SSTABLE_MAGIC = 0x4155524F52414B56ULL;
 
+// v2: [u32 klen][key][u64 seq|type tag][u32 vlen][value] records,
+// sorted by key then newest first, plus named meta blocks
+static constexpr uint64_t SSTABLE_MAGIC_V2 = 0x4155524F52414B32ULL;
+
+struct SSTableFooter {
+    uint64_t indexOffset;
+    uint64_t minKeyOffset;
+    uint64_t maxKeyOffset;
+    uint64_t fileSize;
+    uint64_t metaOffset;   // v2 only (0 for v1 files)
+    uint64_t magic;
+};
+
+// One decoded data record; slices point into the read buffer
+struct SSTableRecord {
+    Slice key;
+    uint64_t tag = 0;
+    Slice value;
+
+    SequenceNumber sequence() const { return tagSequence(tag); }
+};
+
+// Table-wide statistics kept in the "properties" meta block.
+// Stored as named values so fields can be added without a format bump.
+struct SSTableProperties {
+    SequenceNumber smallestSeq = 0;
+    SequenceNumber largestSeq = 0;
+    uint64_t numEntries = 0;
+    uint64_t numDeletions = 0;        // point tombstones among numEntries
+    uint64_t numRangeDeletions = 0;   // fragments in the "rangedel" block
+
+    // Record bytes of point tombstones and of versions shadowed by a
+    // newer one in the same file
+    uint64_t deadBytes = 0;
+
+    // Share of entries (point and range) that delete something
+    double tombstoneRatio() const {
+        const uint64_t all = numEntries + numRangeDeletions;
+        return all ? static_cast<double>(numDeletions + numRangeDeletions) / all : 0.0;
+    }
+};
+
 enum class GetResult {
     NOT_FOUND,
     FOUND,
@@ -24,6 +75,9 @@ struct SSTableIndexEntry {
         : key(k), offset(o) {}
 };
 
+// Immutable once built; shared by copies of a table and its iterators
+using SSTableIndex = std::vector<SSTableIndexEntry>;
+
 class SSTableStatsHook {
 public:
     virtual void recordBloomCheck() = 0;
@@ -42,44 +96,52 @@ public:
             size_t bloomHashCount);
 
     // =======================
-    // COPY CONSTRUCTOR (FIXED ORDER)
-    // =======================
-    SSTable(const SSTable& other)
-        : statsHook(other.statsHook),
-          filePath(other.filePath),
-          bloom(other.bloom),
-          sparseIndex(other.sparseIndex),
-          minKey(other.minKey),
-          maxKey(other.maxKey),
-          fileSize(other.fileSize) {}
-
-    // =======================
-    // ASSIGNMENT OPERATOR
+    // COPY / ASSIGNMENT (memberwise)
     // =======================
-    SSTable& operator=(const SSTable& other) {
-        if (this != &other) {
-            statsHook = other.statsHook;
-            filePath = other.filePath;
-            bloom = other.bloom;
-            sparseIndex = other.sparseIndex;
-            minKey = other.minKey;
-            maxKey = other.maxKey;
-            fileSize = other.fileSize;
-        }
-        return *this;
-    }
+    SSTable(const SSTable& other) = default;
+    SSTable& operator=(const SSTable& other) = default;
 
     // =======================
     // CORE APIs
     // =======================
-    bool writeToDisk(const std::map<std::string, std::string>& data);
-    GetResult get(const std::string& key, std::string& value) const;
+    // Streams `input` (sorted by key, newest version first) into a new
+    // v2 table file. Range tombstones go to the "rangedel" meta block and
+    // widen the file's key range.
+    bool writeToDisk(Iterator& input,
+                     const FragmentedRangeTombstoneList* rangeDels = nullptr);
+
+    // Newest version of `key` with sequence <= snapshot
+    GetResult get(const Slice& key,
+                  std::string& value,
+                  SequenceNumber snapshot = MAX_SEQUENCE_NUMBER) const;
+
+    // Zero-copy lookup: on FOUND, `value` references the cached data block.
+    // `seq` (optional) receives the sequence of the version found, and
+    // `bytesRead` (optional) is increased by the block bytes read from disk.
+    // Range tombstones are not applied here; see maxCoveringTombstone().
+    GetResult get(const Slice& key,
+                  PinnableSlice& value,
+                  SequenceNumber snapshot = MAX_SEQUENCE_NUMBER,
+                  SequenceNumber* seq = nullptr,
+                  uint64_t* bytesRead = nullptr) const;
     const std::string& getFilePath() const;
 
-    void appendKV(const std::string& key,
-                  const std::string& value,
+    void appendKV(const Slice& key,
+                  uint64_t tag,
+                  const Slice& value,
                   std::ofstream& out);
 
+    // Parses one record at p (advancing it); false if truncated.
+    // A non-zero `globalSeq` replaces the stored sequence.
+    static bool decodeRecord(const char*& p,
+                             const char* limit,
+                             bool tagged,
+                             SSTableRecord& rec,
+                             SequenceNumber globalSeq = 0);
+
+    // v2 files carry a sequence/type tag per record
+    bool hasSequenceNumbers() const { return tagged; }
+
     // =======================
     // RANGE METADATA
     // =======================
@@ -87,15 +149,73 @@ public:
     const std::string& getMaxKey() const { return maxKey; }
     uint64_t getFileSize() const { return fileSize; }
 
+    // File offset where data records end and the sparse index begins
+    uint64_t getIndexOffset() const { return indexOffset; }
+
+    const SSTableProperties& getProperties() const { return properties; }
+
+    // Ingested files: every record reads as written at `seq`, which the
+    // manifest keeps (the file itself is not changed)
+    void setGlobalSequence(SequenceNumber seq);
+    SequenceNumber getGlobalSequence() const { return globalSeq; }
+
+    // Memory held by this copy of the table: its bloom filter, sparse
+    // index and range tombstones (the last two are shared with other
+    // copies, so summing over copies counts them more than once)
+    size_t approximateMemoryUsage() const;
+
+    // Bytes a compaction is expected to free: dead records here plus,
+    // per point tombstone, one average-sized record it deletes below
+    uint64_t estimatedDeadBytes() const;
+
+    std::shared_ptr<const SSTableIndex> getSparseIndex() const { return sparseIndex; }
+
+    // Last block whose first key is < key (0 if none). Versions of one
+    // key may straddle a block boundary, so a block that begins exactly
+    // at `key` is not a safe starting point.
+    static size_t findBlock(const SSTableIndex& index, const Slice& key);
+
+    // No point entries and no range tombstones
+    bool isEmpty() const {
+        return properties.numEntries == 0 && properties.numRangeDeletions == 0;
+    }
+
+    // =======================
+    // RANGE TOMBSTONES
+    // =======================
+    // nullptr when the table has none
+    const FragmentedRangeTombstoneList* getRangeTombstones() const {
+        return rangeTombstones.get();
+    }
+
+    // Newest range tombstone covering `key` visible at `snapshot`, or 0
+    SequenceNumber maxCoveringTombstone(const Slice& key,
+                                        SequenceNumber snapshot) const {
+        return rangeTombstones
+                   ? rangeTombstones->maxCoveringSeq(key, snapshot)
+                   : 0;
+    }
+
     // =======================
     // BLOOM FILTER ENTRY
     // =======================
-    bool mightContain(const std::string& key) const;
+    bool mightContain(const Slice& key) const;
 
     void setStatsHook(SSTableStatsHook* hook) {
         statsHook = hook;
     }
 
+    // Shared data-block cache used by get(); optional
+    void setBlockCache(BlockCache* cache) {
+        blockCache = cache;
+    }
+
+    // Charges writeToDisk() output to `limiter`; optional
+    void setRateLimiter(RateLimiter* limiter, IOPriority priority) {
+        rateLimiter = limiter;
+        ioPriority = priority;
+    }
+
 private:
     // =======================
     // MEMBER ORDER (IMPORTANT)
@@ -104,21 +224,74 @@ private:
 
     std::string filePath;                // 2
     BloomFilter bloom;                     // 3
-    std::vector<SSTableIndexEntry> sparseIndex; // 4
+    std::shared_ptr<const SSTableIndex> sparseIndex =
+        std::make_shared<SSTableIndex>();   // 4
 
     std::string minKey;                     // 5
     std::string maxKey;                     // 6
-    uint64_t fileSize = 0;                  // 7 LAST
+    uint64_t fileSize = 0;                  // 7
+    uint64_t indexOffset = 0;               // 8 (end of data blocks)
+    BlockCache* blockCache = nullptr;       // 9
+    bool tagged = false;                    // 10 (v2 record format)
+    SSTableProperties properties;           // 11
+
+    // Shared between copies of this table; immutable once loaded
+    std::shared_ptr<const FragmentedRangeTombstoneList> rangeTombstones; // 12
+
+    RateLimiter* rateLimiter = nullptr;     // 13 (writes only)
+    IOPriority ioPriority = IOPriority::LOW;
+
+    SequenceNumber globalSeq = 0;           // 14 (ingested files)
+
+    // =======================
+    // BUILD (writeToDisk, SSTableWriter)
+    // =======================
+    struct Build {
+        std::ofstream out;
+        std::shared_ptr<SSTableIndex> index;
+        std::string minKey;
+        std::string maxKey;
+        bool first = true;
+        size_t entryCount = 0;
+        uint64_t charged = 0;   // bytes already paid to the rate limiter
+    };
+
+    bool beginBuild(Build& build);
+
+    // Entries must arrive sorted by key, newest version first
+    void addToBuild(Build& build,
+                    const Slice& key,
+                    SequenceNumber seq,
+                    const Slice& value);
+
+    // Range tombstones, index, meta blocks and footer
+    bool finishBuild(Build& build,
+                     const FragmentedRangeTombstoneList* rangeDels);
+
+    friend class SSTableWriter;
 
     // =======================
     // INTERNALS
     // =======================
     void loadFooterMetadata();
     bool isBinarySSTable() const;
-    GetResult getBinary(const std::string& key, std::string& value) const;
+    GetResult getBinary(const Slice& key,
+                        PinnableSlice& value,
+                        SequenceNumber snapshot,
+                        SequenceNumber* seq,
+                        uint64_t* bytesRead) const;
+
+    // Reads the data block starting at sparseIndex[blockIdx]; a read
+    // that misses the block cache adds its size to `bytesRead`
+    std::shared_ptr<const std::string> readBlock(size_t blockIdx,
+                                                 uint64_t* bytesRead = nullptr) const;
 
     void loadBloom();
     void loadSparseIndex();
+    void loadMetaBlocks(uint64_t metaOffset);
+
+    // Reads the footer of either format version
+    static bool readFooter(std::ifstream& in, SSTableFooter& footer);
 };
 
 #endif // SSTABLE_H
\ No newline at end of file
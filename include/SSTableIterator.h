@@ -4,31 +4,59 @@
 #include "Iterator.h"
 #include "SSTable.h"
 #include <fstream>
+#include <vector>
 
+// Sequential reader over an SSTable's data region.
+// Records are parsed in place from a reusable read buffer, so key() and
+// value() point into it and iterating allocates nothing per record.
+// Only the file and the shared sparse index are referenced after
+// construction, so the SSTable object itself may go away while iterating.
 class SSTableIterator : public Iterator{
 public:
 
 
-    explicit SSTableIterator(const SSTable& table);
+    // Background readers (compaction) charge every file read to
+    // `limiter`; foreground iterators pass none
+    explicit SSTableIterator(const SSTable& table,
+                             RateLimiter* limiter = nullptr,
+                             IOPriority priority = IOPriority::LOW);
 
     bool valid() const override;
     void next() override;
 
-    const std::string& key() const override;
-    const std::string& value() const override;
+    Slice key() const override;
+    Slice value() const override;
+    SequenceNumber sequence() const override;
+
+    // Jumps to the right block via the sparse index, then scans
+    void seek(const Slice& target) override;
 
 
 private:
+static constexpr size_t READ_CHUNK = 64 * 1024;
+
 uint64_t dataEnd = 0;
 
     void loadNext();
 
-    const SSTable& table;
+    // Makes sure at least `need` unread bytes are buffered
+    bool fill(size_t need);
+
+    bool tagged = false;
+    SequenceNumber globalSeq = 0;
+    std::shared_ptr<const SSTableIndex> index;
     std::ifstream in;
 
-    std::string curKey;
-    std::string curValue;
+    std::vector<char> buf;
+    size_t bufPos = 0;       // next unread byte in buf
+    size_t bufEnd = 0;       // end of valid bytes in buf
+    uint64_t fileOffset = 0; // next file offset to read into buf
+
+    SSTableRecord cur;
     bool isValid = false;
+
+    RateLimiter* rateLimiter;
+    IOPriority ioPriority;
     
 };
 
@@ -0,0 +1,52 @@
+#ifndef SSTABLE_WRITER_H
+#define SSTABLE_WRITER_H
+
+#include <string>
+#include <cstdint>
+
+#include "SSTable.h"
+#include "Slice.h"
+
+// Builds a table file offline, one entry at a time, in the same format
+// flushes and compactions write, for KVStore::ingestFiles().
+// Keys must be added in strictly increasing order. Records carry
+// sequence 0; ingestion assigns the file a sequence of its own.
+class SSTableWriter {
+public:
+    SSTableWriter(const std::string& path,
+                  size_t bloomBits = 10000,
+                  size_t bloomHashes = 3);
+
+    // false if `key` does not sort after the previous key; the entry is
+    // skipped and finish() will fail
+    bool put(const Slice& key, const Slice& value);
+
+    // Tombstone for `key`
+    bool remove(const Slice& key);
+
+    // Writes the index, meta blocks and footer; false if an entry was
+    // rejected or the file could not be written, and then no file is
+    // left behind
+    bool finish();
+
+    uint64_t getEntryCount() const { return entries; }
+    uint64_t getFileSize() const { return table.getFileSize(); }
+
+private:
+    bool add(const Slice& key, const Slice& value);
+
+    // Drops the partial file
+    void abandon();
+
+    SSTable table;
+    SSTable::Build build;
+
+    std::string lastKey;
+    uint64_t entries = 0;
+
+    bool opened = false;
+    bool failed = false;
+    bool finished = false;
+};
+
+#endif
@@ -0,0 +1,81 @@
+#ifndef SKIPLIST_H
+#define SKIPLIST_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+#include "Slice.h"
+#include "InternalKey.h"
+
+// Ordered index of a MemTable's versions, in InternalKey order.
+// One writer at a time (the caller serializes insert()); readers take no
+// lock and may run alongside it. A node is fully built before it is
+// linked in, links are published with release stores, and nodes never
+// move or go away before the list does.
+class SkipList {
+public:
+    static constexpr int MAX_HEIGHT = 12;
+
+    struct Node {
+        InternalKey key;
+        std::string value;
+        const int height;
+
+        Node(const Slice& k, SequenceNumber seq, const Slice& v, int h)
+            : key(k, seq), value(v.data(), v.size()), height(h) {}
+
+        Node* next(int level) const {
+            return links[level].load(std::memory_order_acquire);
+        }
+
+        void setNext(int level, Node* node) {
+            links[level].store(node, std::memory_order_release);
+        }
+
+        // `height` links, allocated along with the node
+        std::atomic<Node*> links[1];
+    };
+
+    SkipList();
+    ~SkipList();
+
+    SkipList(const SkipList&) = delete;
+    SkipList& operator=(const SkipList&) = delete;
+
+    // Links a new version in; nullptr if (key, seq) is already there
+    const Node* insert(const Slice& key, SequenceNumber seq, const Slice& value);
+
+    // First node not before `target`, or nullptr
+    const Node* lowerBound(const LookupKey& target) const;
+
+    const Node* first() const { return head->next(0); }
+
+    bool empty() const { return first() == nullptr; }
+    size_t size() const { return count.load(std::memory_order_relaxed); }
+
+    // Frees every node; no reader may be active
+    void clear();
+
+    // Bytes ::operator new is asked for by a node of `height` links
+    static size_t nodeSize(int height) {
+        return sizeof(Node) + (height - 1) * sizeof(std::atomic<Node*>);
+    }
+
+private:
+    static Node* newNode(const Slice& key, SequenceNumber seq,
+                         const Slice& value, int height);
+    static void deleteNode(Node* node);
+
+    // Last node before `target` on each level goes into prev (if given)
+    Node* findGreaterOrEqual(const LookupKey& target, Node** prev) const;
+
+    int randomHeight();
+
+    Node* const head;
+    std::atomic<int> maxHeight{1};
+    std::atomic<size_t> count{0};
+    uint32_t rnd = 0xdeadbeef;    // writer only
+};
+
+#endif
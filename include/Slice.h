@@ -0,0 +1,61 @@
+#ifndef SLICE_H
+#define SLICE_H
+
+#include <string>
+#include <string_view>
+#include <cstring>
+#include <cstddef>
+
+// Non-owning view over a key or value.
+// The referenced bytes must outlive the slice.
+class Slice {
+public:
+    Slice() = default;
+
+    Slice(const char* d, size_t n) : ptr(d), len(n) {}
+
+    Slice(const std::string& s) : ptr(s.data()), len(s.size()) {}
+
+    Slice(std::string_view s) : ptr(s.data()), len(s.size()) {}
+
+    Slice(const char* s) : ptr(s), len(std::strlen(s)) {}
+
+    const char* data() const { return ptr; }
+    size_t size() const { return len; }
+    bool empty() const { return len == 0; }
+
+    char operator[](size_t i) const { return ptr[i]; }
+
+    std::string toString() const { return std::string(ptr, len); }
+
+    operator std::string_view() const { return std::string_view(ptr, len); }
+
+    // <0, 0, >0 like std::string::compare (bytewise)
+    int compare(const Slice& other) const {
+        const size_t minLen = len < other.len ? len : other.len;
+        int r = minLen ? std::memcmp(ptr, other.ptr, minLen) : 0;
+        if (r == 0) {
+            if (len < other.len) r = -1;
+            else if (len > other.len) r = 1;
+        }
+        return r;
+    }
+
+protected:
+    const char* ptr = "";
+    size_t len = 0;
+};
+
+inline bool operator==(const Slice& a, const Slice& b) {
+    return a.size() == b.size() &&
+           (a.size() == 0 || std::memcmp(a.data(), b.data(), a.size()) == 0);
+}
+
+inline bool operator!=(const Slice& a, const Slice& b) { return !(a == b); }
+
+inline bool operator<(const Slice& a, const Slice& b) { return a.compare(b) < 0; }
+inline bool operator>(const Slice& a, const Slice& b) { return a.compare(b) > 0; }
+inline bool operator<=(const Slice& a, const Slice& b) { return a.compare(b) <= 0; }
+inline bool operator>=(const Slice& a, const Slice& b) { return a.compare(b) >= 0; }
+
+#endif
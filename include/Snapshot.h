@@ -0,0 +1,21 @@
+#ifndef SNAPSHOT_H
+#define SNAPSHOT_H
+
+#include "InternalKey.h"
+
+// Consistent read view handed out by KVStore::getSnapshot().
+// Reads through a snapshot see exactly the writes with a sequence
+// number <= getSequenceNumber(). Must be returned via releaseSnapshot().
+class Snapshot {
+public:
+    SequenceNumber getSequenceNumber() const { return sequence; }
+
+private:
+    friend class KVStore;
+
+    explicit Snapshot(SequenceNumber seq) : sequence(seq) {}
+
+    SequenceNumber sequence;
+};
+
+#endif
@@ -0,0 +1,164 @@
+#ifndef STATISTICS_H
+#define STATISTICS_H
+
+#include <atomic>
+#include <chrono>
+#include <string>
+#include <cstdint>
+#include <cstddef>
+#include <algorithm>
+
+#include "Histogram.h"
+
+// Monotonic event counters
+enum class Ticker : uint32_t {
+    PUTS,
+    GETS,
+    DELETES,
+    RANGE_DELETES,
+    BYTES_WRITTEN,          // user key + value bytes
+    FLUSHES,
+    FLUSH_BYTES,            // SSTable bytes written by flush
+    COMPACTIONS,
+    COMPACTION_BYTES_READ,
+    COMPACTION_BYTES_WRITTEN,
+    SUBCOMPACTIONS,                 // key-range slices run by compactions
+    TRIVIAL_MOVES,                  // compactions that only changed a file's level
+    TRIVIAL_MOVE_BYTES,             // bytes those moves did not rewrite
+    TOMBSTONE_COMPACTIONS,          // started by a file's tombstone ratio
+    INGESTED_FILES,                 // added by ingestFiles()
+    INGESTED_BYTES,
+    WRITE_BUFFER_MANAGER_FLUSHES,   // MemTables sealed for the global budget
+    SSTABLES_READ,          // tables searched by point lookups
+    BLOOM_CHECKS,
+    BLOOM_NEGATIVES,
+    BLOOM_FALSE_POSITIVES,
+    CACHE_HITS,
+    CACHE_MISSES,
+    STALLED_WRITES,                 // writes delayed or stopped
+    STALL_SLOWDOWN_NANOS,
+    STALL_STOP_NANOS,
+    STALL_L0_FILES_NANOS,           // stall time by cause
+    STALL_MEMTABLES_NANOS,
+    STALL_PENDING_COMPACTION_NANOS,
+    TICKER_COUNT
+};
+
+// Distributions; latencies in nanoseconds, sizes in bytes
+enum class HistogramType : uint32_t {
+    GET_LATENCY,
+    PUT_LATENCY,
+    FLUSH_LATENCY,
+    COMPACTION_LATENCY,
+    FLUSH_BYTES,
+    COMPACTION_BYTES,
+    HISTOGRAM_COUNT
+};
+
+// Per-level counters; compaction ones are booked on the output level
+enum class LevelCounter : uint32_t {
+    FLUSH_BYTES,                // SSTable bytes flushed into the level (L0)
+    COMPACTION_READ_UPPER,      // input bytes taken from the level above
+    COMPACTION_READ_LOWER,      // input bytes taken from this level
+    COMPACTION_WRITTEN,         // output bytes written into this level
+    COMPACTIONS,
+    COMPACTION_NANOS,
+    TRIVIAL_MOVE_BYTES,         // bytes moved into the level without a rewrite
+    GET_TABLES_READ,            // SSTables searched by point lookups
+    GET_BYTES_READ,             // block bytes point lookups read from disk
+    LEVEL_COUNTER_COUNT
+};
+
+static constexpr size_t TICKER_COUNT = static_cast<size_t>(Ticker::TICKER_COUNT);
+static constexpr size_t HISTOGRAM_COUNT = static_cast<size_t>(HistogramType::HISTOGRAM_COUNT);
+static constexpr size_t LEVEL_COUNTER_COUNT = static_cast<size_t>(LevelCounter::LEVEL_COUNTER_COUNT);
+
+// Engine-wide statistics, safe to update from any thread.
+// Tickers live in cache-line-aligned shards picked per thread, so hot
+// counters don't bounce one cache line between cores; reads sum the
+// shards. Histograms record with relaxed atomics.
+class Statistics {
+public:
+    Statistics();
+
+    Statistics(const Statistics&) = delete;
+    Statistics& operator=(const Statistics&) = delete;
+
+    void recordTick(Ticker ticker, uint64_t count = 1) {
+        shards[shardIndex()].tickers[static_cast<size_t>(ticker)]
+            .fetch_add(count, std::memory_order_relaxed);
+    }
+
+    // Levels past MAX_TRACKED_LEVELS share the last slot
+    void recordLevel(size_t level, LevelCounter counter, uint64_t count = 1) {
+        shards[shardIndex()].levels[std::min(level, MAX_TRACKED_LEVELS - 1)]
+            [static_cast<size_t>(counter)].fetch_add(count, std::memory_order_relaxed);
+    }
+
+    void measure(HistogramType type, uint64_t value) {
+        histograms[static_cast<size_t>(type)].record(value);
+    }
+
+    uint64_t getTickerCount(Ticker ticker) const;
+
+    uint64_t getLevelCount(size_t level, LevelCounter counter) const;
+
+    HistogramSnapshot getHistogram(HistogramType type) const;
+
+    void reset();
+
+    static const char* tickerName(Ticker ticker);
+    static const char* histogramName(HistogramType type);
+    static const char* levelCounterName(LevelCounter counter);
+
+    static constexpr size_t MAX_TRACKED_LEVELS = 16;
+
+    // Versioned binary encoding. Entries are keyed by name, so files
+    // written before a ticker or histogram was added still load.
+    std::string serialize() const;
+
+    // Adds the decoded values on top of the current ones.
+    // False (and nothing applied) if `data` isn't a stats record.
+    bool deserialize(const std::string& data);
+
+    bool saveTo(const std::string& path) const;
+    bool loadFrom(const std::string& path);
+
+    // Multi-line "name : value" dump of every ticker and histogram
+    std::string toString() const;
+
+private:
+    static constexpr size_t SHARDS = 16;
+
+    struct alignas(64) Shard {
+        std::atomic<uint64_t> tickers[TICKER_COUNT];
+        std::atomic<uint64_t> levels[MAX_TRACKED_LEVELS][LEVEL_COUNTER_COUNT];
+    };
+
+    static size_t shardIndex();
+
+    Shard shards[SHARDS];
+    Histogram histograms[HISTOGRAM_COUNT];
+};
+
+// Records the time between construction and destruction into a histogram
+class StopWatch {
+public:
+    StopWatch(Statistics& stats, HistogramType type)
+        : stats(stats), type(type), start(std::chrono::steady_clock::now()) {}
+
+    ~StopWatch() {
+        stats.measure(type, std::chrono::duration_cast<std::chrono::nanoseconds>(
+                                std::chrono::steady_clock::now() - start).count());
+    }
+
+    StopWatch(const StopWatch&) = delete;
+    StopWatch& operator=(const StopWatch&) = delete;
+
+private:
+    Statistics& stats;
+    HistogramType type;
+    std::chrono::steady_clock::time_point start;
+};
+
+#endif
@@ -39,6 +39,14 @@ public:
         return true;
     }
 
+    // Memory of the cached table copies
+    size_t getUsage() const {
+        size_t bytes = 0;
+        for (const auto& entry : cache)
+            bytes += entry.first.capacity() + entry.second.second.approximateMemoryUsage();
+        return bytes;
+    }
+
     void put(const std::string& file, const SSTable& table) {
 
         auto it = cache.find(file);
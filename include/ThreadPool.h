@@ -0,0 +1,81 @@
+#ifndef THREAD_POOL_H
+#define THREAD_POOL_H
+
+#include <string>
+#include <vector>
+#include <queue>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+#include <chrono>
+#include <cstdint>
+
+// Point-in-time view of a pool
+struct ThreadPoolStats {
+    size_t threads = 0;
+    size_t queued = 0;          // jobs waiting for a thread
+    size_t active = 0;          // jobs running now
+    uint64_t completed = 0;
+
+    // Busy thread time over available thread time since the pool started
+    double utilization = 0;
+};
+
+// Fixed set of worker threads running scheduled jobs.
+// The job with the highest score runs first; equal scores run in
+// scheduling order.
+class ThreadPool {
+public:
+    ThreadPool(const std::string& name, size_t threads);
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    void schedule(std::function<void()> job, double score = 0);
+
+    // Waits for running jobs and discards queued ones; idempotent
+    void shutdown();
+
+    ThreadPoolStats getStats() const;
+
+    const std::string& getName() const { return name; }
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    struct Job {
+        double score;
+        uint64_t order;
+        std::function<void()> run;
+
+        // priority_queue pops the largest: higher score, then older
+        bool operator<(const Job& other) const {
+            if (score != other.score)
+                return score < other.score;
+            return order > other.order;
+        }
+    };
+
+    // `slot` indexes runningSince
+    void workerLoop(size_t slot);
+
+    std::string name;
+    std::vector<std::thread> workers;
+
+    mutable std::mutex mtx;
+    std::condition_variable ready;
+    std::priority_queue<Job> queue;
+
+    bool stopping = false;
+    uint64_t nextOrder = 0;
+    size_t active = 0;
+    uint64_t completed = 0;
+
+    Clock::time_point started;
+    uint64_t busyNanos = 0;     // finished jobs only
+    std::vector<Clock::time_point> runningSince;
+};
+
+#endif
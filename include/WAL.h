@@ -6,16 +6,31 @@
 #include <cstdint>
 #include <mutex>
 
+#include "Slice.h"
+#include "InternalKey.h"
+
 class MemTable;
 
 class WAL {
 public:
     explicit WAL(const std::string& path, size_t batchSize = 10);
 
-    void logPut(const std::string& key, const std::string& value);
-    void logDelete(const std::string& key);
+    void logPut(const Slice& key, const Slice& value, SequenceNumber seq);
+    void logDelete(const Slice& key, SequenceNumber seq);
+    void logDeleteRange(const Slice& start, const Slice& end, SequenceNumber seq);
+
+    // Rebuilds the MemTable from the sealed logs (oldest first) and the
+    // active log; lastSequence is raised to the newest replayed sequence
+    // (legacy records are numbered after it)
+    void replay(MemTable& memTable, SequenceNumber& lastSequence);
+
+    // Closes the active log under a new name ("<path>.<n>") so it can be
+    // deleted once its MemTable is flushed; later writes start a fresh
+    // log. Returns the sealed path, or "" if nothing was logged.
+    std::string rotate();
 
-    void replay(MemTable& memTable);
+    // Sealed logs left on disk, oldest first
+    std::vector<std::string> sealedLogs() const;
 
     void flush();
     void clear();
@@ -25,9 +40,18 @@ private:
     std::vector<char> buffer;   // binary buffer
     size_t batchSize;
     std::mutex mtx;
+    uint64_t nextLogNumber = 0;
 
     void appendUInt32(uint32_t v);
+    void appendUInt64(uint64_t v);
     void flushUnlocked();   // NEW
+
+    // <n> of a "<log name>.<n>" file name, or -1 for other files
+    long long sealedNumber(const std::string& fileName) const;
+
+    static void replayFile(const std::string& file,
+                           MemTable& memTable,
+                           SequenceNumber& lastSequence);
 };
 
 #endif
\ No newline at end of file
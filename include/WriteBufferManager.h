@@ -0,0 +1,62 @@
+#ifndef WRITE_BUFFER_MANAGER_H
+#define WRITE_BUFFER_MANAGER_H
+
+#include <atomic>
+#include <mutex>
+#include <vector>
+#include <cstddef>
+
+// A store whose MemTables the manager can ask to flush
+class WriteBufferClient {
+public:
+    virtual ~WriteBufferClient() = default;
+
+    // Bytes held by the MemTable still taking writes
+    virtual size_t activeMemTableBytes() const = 0;
+
+    // Seals the active MemTable and schedules its flush
+    virtual void requestFlush() = 0;
+};
+
+// Process-wide MemTable memory budget shared by every open store.
+// MemTables charge what they allocate here while they grow, move it
+// from mutable to immutable when sealed, and return it once freed.
+// When the budget is tight the client with the largest active MemTable
+// is asked to flush.
+class WriteBufferManager {
+public:
+    static WriteBufferManager& global();
+
+    // 0 = no limit
+    void setBufferSize(size_t bytes);
+    size_t getBufferSize() const { return bufferSize.load(); }
+
+    void reserveMem(size_t bytes);
+    void scheduleFreeMem(size_t bytes);   // sealed: no longer mutable
+    void freeMem(size_t bytes);           // released
+
+    size_t memoryUsage() const { return memoryUsed.load(); }
+    size_t mutableMemoryUsage() const { return mutableUsed.load(); }
+
+    // Mutable memory above 7/8 of the budget, or the budget exceeded
+    // with at least half of it still mutable (sealed MemTables are
+    // already on their way out)
+    bool shouldFlush() const;
+
+    // If shouldFlush(), asks the client with the largest active
+    // MemTable to flush. Callers must not hold a client's locks.
+    void maybeFlush();
+
+    void registerClient(WriteBufferClient* client);
+    void unregisterClient(WriteBufferClient* client);
+
+private:
+    std::atomic<size_t> bufferSize{0};
+    std::atomic<size_t> memoryUsed{0};
+    std::atomic<size_t> mutableUsed{0};
+
+    std::mutex mtx;   // clients; held while a flush is requested
+    std::vector<WriteBufferClient*> clients;
+};
+
+#endif
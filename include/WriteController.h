@@ -0,0 +1,94 @@
+#ifndef WRITE_CONTROLLER_H
+#define WRITE_CONTROLLER_H
+
+#include <mutex>
+#include <condition_variable>
+#include <chrono>
+#include <cstdint>
+
+#include "Statistics.h"
+
+struct WriteControllerOptions {
+    // L0 file count (compaction starts at l0_threshold)
+    int l0SlowdownTrigger = 20;
+    int l0StopTrigger = 36;
+
+    // MemTables sealed and waiting for flush
+    int immutableSlowdownTrigger = 2;
+    int immutableStopTrigger = 4;
+
+    // Estimated bytes compaction still has to rewrite
+    uint64_t pendingCompactionSlowdownBytes = 64ULL << 20;
+    uint64_t pendingCompactionStopBytes = 256ULL << 20;
+
+    // Write rate (bytes/sec) when a slowdown begins; it shrinks toward
+    // delayedWriteRate / 16 as the tree approaches a stop trigger
+    uint64_t delayedWriteRate = 16ULL << 20;
+};
+
+enum class WriteCondition {
+    NORMAL,
+    DELAYED,    // writes pass through a token bucket
+    STOPPED     // writes block until background work catches up
+};
+
+enum class StallCause {
+    NONE,
+    L0_FILES,
+    IMMUTABLE_MEMTABLES,
+    PENDING_COMPACTION_BYTES
+};
+
+// Throttles foreground writes while flush and compaction are behind.
+// The store reports the shape of the tree after every flush and
+// compaction; writers ask for permission before each write.
+class WriteController {
+public:
+    explicit WriteController(const WriteControllerOptions& options = {});
+
+    // Replaces the triggers; takes effect at the next update()
+    void setOptions(const WriteControllerOptions& options);
+
+    // Recomputes the condition; wakes stopped writers if it improved
+    void update(int l0Files, int immutableMemTables, uint64_t pendingCompactionBytes);
+
+    // Charges `bytes` to the token bucket (delayed) or waits until writes
+    // are allowed again (stopped). Time spent is counted in `stats`.
+    void delayWrite(uint64_t bytes, Statistics& stats);
+
+    // Releases blocked writers for good (store shutdown)
+    void shutdown();
+
+    WriteCondition getCondition() const;
+    StallCause getCause() const;
+
+    // Current token bucket rate in bytes/sec (0 when not delayed)
+    uint64_t getDelayedWriteRate() const;
+
+    static const char* causeName(StallCause cause);
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    // Sleep owed by a write of `bytes` at the current rate (mtx held)
+    std::chrono::nanoseconds takeTokens(uint64_t bytes);
+
+    static void recordStall(Statistics& stats, StallCause cause,
+                            bool stopped, uint64_t nanos);
+
+    WriteControllerOptions options;
+
+    mutable std::mutex mtx;
+    std::condition_variable writable;
+
+    WriteCondition condition = WriteCondition::NORMAL;
+    StallCause cause = StallCause::NONE;
+    bool stopping = false;
+
+    // Token bucket: credit in bytes, negative while writers owe time
+    uint64_t rate = 0;
+    double credit = 0;
+    Clock::time_point lastRefill;
+};
+
+#endif
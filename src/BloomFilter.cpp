@@ -4,6 +4,8 @@
 #include<bits/stdc++.h>
 #include <cstdint>
 
+#include "PerfContext.h"
+
 
 
 BloomFilter::BloomFilter(size_t bitSize, size_t hashCount)
@@ -12,9 +14,13 @@ BloomFilter::BloomFilter(size_t bitSize, size_t hashCount)
       bitArray(bitSize,0) {}
 
 
-void BloomFilter::add(const std::string& key){
+void BloomFilter::add(const Slice& key){
+    size_t h = hash(key);
+    const size_t delta = (h >> 17) | (h << 15);
+
     for (size_t i = 0; i < hashCount; ++i) {
-        bitArray[hash(key, i) % bitSize] = 1;
+        bitArray[h % bitSize] = 1;
+        h += delta;
     }
 }
 
@@ -24,15 +30,24 @@ void BloomFilter::serialize(std::ofstream& out) const{
     out.write(reinterpret_cast<const char*>(bitArray.data()), size);
 }
 
-bool BloomFilter::mightContain(const std::string& key) const{
+bool BloomFilter::mightContain(const Slice& key) const{
+    PERF_TIMER_GUARD(bloomNanos);
+    PERF_COUNTER_ADD(bloomProbes, 1);
+
+    size_t h = hash(key);
+    const size_t delta = (h >> 17) | (h << 15);
+
     for(size_t i = 0; i < hashCount; ++i){
-        if(!bitArray[hash(key, i) % bitSize]){
+        if(!bitArray[h % bitSize]){
             return false;
         }
+        h += delta;
     }
+
+    PERF_COUNTER_ADD(bloomHits, 1);
     return true;
 }
 
-size_t BloomFilter::hash(const std::string& key, size_t seed) const{
-    return std::hash<std::string>{}(key + std::to_string(seed));
+size_t BloomFilter::hash(const Slice& key) const{
+    return std::hash<std::string_view>{}(std::string_view(key));
 }
@@ -6,7 +6,17 @@
 #include <fstream>
 #include <map>
 
+#include <memory>
+#include <cstdio>
+#include <chrono>
+#include <atomic>
+#include <thread>
+#include <filesystem>
+
 #include "SSTableIterator.h"
+#include "MergeIterator.h"
+#include "CompactionIterator.h"
+#include "RangeIterator.h"
 #include "MemTable.h"
 #include "SSTable.h"
 
@@ -28,124 +38,671 @@ static bool rangesOverlap(const SSTable& a,
              b.getMaxKey() < a.getMinKey());
 }
 
+bool Compaction::parsePriority(const std::string& name, Priority& p) {
+
+    if (name == "min_overlapping_ratio")      p = Priority::MIN_OVERLAPPING_RATIO;
+    else if (name == "oldest_smallest_seq")   p = Priority::OLDEST_SMALLEST_SEQ;
+    else if (name == "round_robin")           p = Priority::ROUND_ROBIN;
+    else if (name == "tombstone_density")     p = Priority::TOMBSTONE_DENSITY;
+    else return false;
+
+    return true;
+}
+
+bool Compaction::conflicts(size_t outputLevel,
+                           const std::string& smallest,
+                           const std::string& largest) const {
+
+    for (const CompactionJob* job : inFlight) {
+        if (job->outputLevel != outputLevel)
+            continue;
+
+        if (!(largest < job->smallest || job->largest < smallest))
+            return true;
+    }
+
+    return false;
+}
+
 // =======================
-// 🔥 FINAL CORRECT COMPACTION (STRICT)
+// PICK
 // =======================
-uint64_t Compaction::run(std::vector<std::vector<SSTable>>& levels){
+std::vector<size_t> Compaction::candidateOrder(
+        const std::vector<std::vector<SSTable>>& levels,
+        size_t level) const {
 
-    for (size_t level = 0; level + 1 < levels.size(); ++level) {
+    if (level == 0)
+        return {0};
 
-        if (levels[level].empty())
-            continue;
+    const std::vector<SSTable>& files = levels[level];
+
+    std::vector<size_t> order(files.size());
+    for (size_t i = 0; i < order.size(); ++i)
+        order[i] = i;
+
+    switch (priority) {
 
-        SSTable& candidate = levels[level].front();
+        case Priority::MIN_OVERLAPPING_RATIO: {
+            // Both levels are sorted and non-overlapping, so each file's
+            // overlap is a contiguous run of the next level
+            const std::vector<SSTable>& next = levels[level + 1];
+            std::vector<double> ratio(files.size(), 0.0);
 
-        std::vector<size_t> overlapIndexes;
+            size_t j = 0;
+            for (size_t i = 0; i < files.size(); ++i) {
+                while (j < next.size() && next[j].getMaxKey() < files[i].getMinKey())
+                    ++j;
 
-        for (size_t i = 0; i < levels[level + 1].size(); ++i) {
-            if (rangesOverlap(candidate,
-                              levels[level + 1][i])) {
-                overlapIndexes.push_back(i);
+                uint64_t overlap = 0;
+                for (size_t k = j; k < next.size() &&
+                                   !(files[i].getMaxKey() < next[k].getMinKey()); ++k)
+                    overlap += next[k].getFileSize();
+
+                ratio[i] = static_cast<double>(overlap) /
+                           std::max<uint64_t>(1, files[i].getFileSize());
             }
+
+            std::stable_sort(order.begin(), order.end(),
+                             [&](size_t a, size_t b) { return ratio[a] < ratio[b]; });
+            break;
         }
 
-        std::cout << "Compacting Level "
-                  << level << " -> " << (level + 1)
-                  << " (overlap files: "
-                  << overlapIndexes.size()
-                  << ")" << std::endl;
+        case Priority::OLDEST_SMALLEST_SEQ:
+            std::stable_sort(order.begin(), order.end(), [&](size_t a, size_t b) {
+                return files[a].getProperties().smallestSeq <
+                       files[b].getProperties().smallestSeq;
+            });
+            break;
+
+        case Priority::ROUND_ROBIN: {
+            // Resume after the last file picked, wrapping around
+            const std::string& cursor = level < cursors.size() ? cursors[level]
+                                                               : std::string();
+            size_t start = 0;
+            if (!cursor.empty())
+                while (start < files.size() && !(cursor < files[start].getMinKey()))
+                    ++start;
+
+            std::rotate(order.begin(), order.begin() + start, order.end());
+            break;
+        }
 
-        std::map<std::string, std::string> merged;
+        case Priority::TOMBSTONE_DENSITY: {
+            auto density = [&](size_t i) {
+                const SSTableProperties& p = files[i].getProperties();
+                return static_cast<double>(p.numDeletions + p.numRangeDeletions) /
+                       std::max<uint64_t>(1, p.numEntries);
+            };
 
-        // NEWEST FIRST
-        std::vector<SSTable*> tables;
-        tables.push_back(&candidate);
+            std::vector<double> d(files.size());
+            for (size_t i = 0; i < files.size(); ++i)
+                d[i] = density(i);
 
-        for (size_t idx : overlapIndexes) {
-            tables.push_back(&levels[level + 1][idx]);
+            std::stable_sort(order.begin(), order.end(),
+                             [&](size_t a, size_t b) { return d[a] > d[b]; });
+            break;
         }
+    }
 
-        for (auto* table : tables) {
+    return order;
+}
 
-            std::ifstream in(table->getFilePath(), std::ios::binary);
-            if (!in.is_open()) continue;
+// Key ranges below the output level that the job's range overlaps,
+// sorted and merged: tombstones may only go where nothing older can
+// sit underneath
+static void setOlderData(const std::vector<std::vector<SSTable>>& levels,
+                         CompactionJob& job) {
+
+    for (size_t deeper = job.outputLevel + 1; deeper < levels.size(); ++deeper) {
+        for (const SSTable& t : levels[deeper]) {
+            if (t.getMaxKey() < job.smallest || job.largest < t.getMinKey())
+                continue;
+            job.olderData.push_back(KeyRange{t.getMinKey(), t.getMaxKey()});
+        }
+    }
+
+    std::sort(job.olderData.begin(), job.olderData.end(),
+              [](const KeyRange& a, const KeyRange& b) { return a.smallest < b.smallest; });
+
+    std::vector<KeyRange> merged;
+    for (KeyRange& r : job.olderData) {
+        if (!merged.empty() && !(merged.back().largest < r.smallest))
+            merged.back().largest = std::max(merged.back().largest, r.largest);
+        else
+            merged.push_back(std::move(r));
+    }
+
+    job.olderData = std::move(merged);
+    job.bottommost = job.olderData.empty();
+}
+
+std::unique_ptr<CompactionJob> Compaction::tryPick(
+        const std::vector<std::vector<SSTable>>& levels,
+        size_t level, size_t index, double score) {
+
+    const SSTable& candidate = levels[level][index];
+
+    auto job = std::make_unique<CompactionJob>();
+    job->level = level;
+    job->outputLevel = level + 1;
+    job->score = score;
+    job->upper.push_back(candidate);
+    job->smallest = candidate.getMinKey();
+    job->largest = candidate.getMaxKey();
 
-            while (in.good()) {
+    for (const SSTable& t : levels[level + 1]) {
+        if (!rangesOverlap(candidate, t))
+            continue;
+
+        if (isCompacting(t.getFilePath()))
+            return nullptr;
+
+        job->lower.push_back(t);
+        job->smallest = std::min(job->smallest, t.getMinKey());
+        job->largest = std::max(job->largest, t.getMaxKey());
+    }
+
+    if (conflicts(level + 1, job->smallest, job->largest))
+        return nullptr;
 
-                uint32_t k, v;
+    job->trivialMove = job->lower.empty();
 
-                if (!in.read(reinterpret_cast<char*>(&k), sizeof(k)))
-                    break;
+    setOlderData(levels, *job);
 
-                std::string key(k, '\0');
-                in.read(&key[0], k);
+    for (const SSTable& t : job->upper)
+        reserved.insert(t.getFilePath());
+    for (const SSTable& t : job->lower)
+        reserved.insert(t.getFilePath());
 
-                if (!in.read(reinterpret_cast<char*>(&v), sizeof(v)))
-                    break;
+    inFlight.push_back(job.get());
+    return job;
+}
+
+std::unique_ptr<CompactionJob> Compaction::pick(
+        const std::vector<std::vector<SSTable>>& levels,
+        const std::vector<double>& scores) {
+
+    std::vector<size_t> order;
+    for (size_t level = 0; level + 1 < levels.size() && level < scores.size(); ++level)
+        if (scores[level] >= 1.0 && !levels[level].empty())
+            order.push_back(level);
+
+    std::stable_sort(order.begin(), order.end(),
+                     [&](size_t a, size_t b) { return scores[a] > scores[b]; });
+
+    for (size_t level : order) {
+
+        // L0 files overlap each other: only the oldest may move down,
+        // and only one at a time, or an older version could end up
+        // above a newer one
+        if (level == 0) {
+            bool busy = false;
+            for (const CompactionJob* job : inFlight)
+                if (job->level == 0)
+                    busy = true;
+            if (busy)
+                continue;
+        }
 
-                std::string value(v, '\0');
-                in.read(&value[0], v);
+        for (size_t i : candidateOrder(levels, level)) {
 
-                // 🔥 CRITICAL FIX
-                if (merged.find(key) != merged.end())
-                    continue;
+            if (isCompacting(levels[level][i].getFilePath()))
+                continue;
 
-                if (value == MemTable::TOMBSTONE) {
-                    // mark deleted (do nothing, but block older values)
-                    merged[key] = MemTable::TOMBSTONE;
-                } else {
-                    merged[key] = value;
-                }
+            std::unique_ptr<CompactionJob> job = tryPick(levels, level, i, scores[level]);
+            if (!job)
+                continue;
+
+            if (priority == Priority::ROUND_ROBIN) {
+                if (cursors.size() < levels.size())
+                    cursors.resize(levels.size());
+                cursors[level] = levels[level][i].getMaxKey();
             }
+
+            return job;
         }
+    }
+
+    // Files dense with tombstones move down even when their level is
+    // within budget, so space freed by deletes comes back
+    if (tombstoneRatioTrigger <= 0)
+        return nullptr;
+
+    for (size_t level = 1; level + 1 < levels.size(); ++level) {
+        for (size_t i = 0; i < levels[level].size(); ++i) {
+
+            const SSTable& candidate = levels[level][i];
+            const SSTableProperties& props = candidate.getProperties();
+
+            if (isCompacting(candidate.getFilePath()) ||
+                props.numDeletions + props.numRangeDeletions < MIN_TRIGGER_TOMBSTONES ||
+                props.tombstoneRatio() < tombstoneRatioTrigger)
+                continue;
+
+            std::unique_ptr<CompactionJob> job =
+                tryPick(levels, level, i, props.tombstoneRatio());
+            if (!job)
+                continue;
 
-        // Remove tombstones before writing
-        for (auto it = merged.begin(); it != merged.end();) {
-            if (it->second == MemTable::TOMBSTONE)
-                it = merged.erase(it);
-            else
-                ++it;
+            job->tombstoneTriggered = true;
+
+            // Moved as is, the tombstones would still be there; with
+            // nothing older below, a rewrite drops them
+            if (job->bottommost)
+                job->trivialMove = false;
+
+            return job;
         }
+    }
+
+    return nullptr;
+}
+
+std::unique_ptr<CompactionJob> Compaction::pickL0(
+        const std::vector<std::vector<SSTable>>& levels) {
+
+    if (levels.size() < 2 || levels[0].empty())
+        return nullptr;
+
+    auto job = std::make_unique<CompactionJob>();
+    job->level = 0;
+    job->score = 1.0;
+
+    // levels[0] is oldest first
+    for (auto it = levels[0].rbegin(); it != levels[0].rend(); ++it) {
+        if (isCompacting(it->getFilePath()))
+            return nullptr;
+        job->upper.push_back(*it);
+    }
+
+    job->smallest = job->upper.front().getMinKey();
+    job->largest = job->upper.front().getMaxKey();
+
+    for (const SSTable& t : job->upper) {
+        job->smallest = std::min(job->smallest, t.getMinKey());
+        job->largest = std::max(job->largest, t.getMaxKey());
+    }
+
+    auto overlaps = [&](const SSTable& t) {
+        return !(t.getMaxKey() < job->smallest || job->largest < t.getMinKey());
+    };
+
+    // Deepest level reachable without passing older data on the way
+    job->outputLevel = 1;
+    for (size_t level = 1; level < levels.size(); ++level) {
+        job->outputLevel = level;
+        if (std::any_of(levels[level].begin(), levels[level].end(), overlaps))
+            break;
+    }
+
+    for (const SSTable& t : levels[job->outputLevel]) {
+        if (!overlaps(t))
+            continue;
+
+        if (isCompacting(t.getFilePath()))
+            return nullptr;
+
+        job->lower.push_back(t);
+    }
+
+    for (const SSTable& t : job->lower) {
+        job->smallest = std::min(job->smallest, t.getMinKey());
+        job->largest = std::max(job->largest, t.getMaxKey());
+    }
+
+    if (conflicts(job->outputLevel, job->smallest, job->largest))
+        return nullptr;
+
+    job->trivialMove = job->upper.size() == 1 && job->lower.empty();
+
+    setOlderData(levels, *job);
+
+    for (const SSTable& t : job->upper)
+        reserved.insert(t.getFilePath());
+    for (const SSTable& t : job->lower)
+        reserved.insert(t.getFilePath());
+
+    inFlight.push_back(job.get());
+    return job;
+}
+
+// =======================
+// EXECUTE
+// =======================
+std::vector<std::string> Compaction::subcompactionBoundaries(const CompactionJob& job,
+                                                             uint64_t inputBytes) const {
+
+    const size_t wanted = std::min<uint64_t>(
+        maxSubcompactions, std::max<uint64_t>(1, inputBytes / MIN_SUBCOMPACTION_BYTES));
+
+    if (wanted <= 1)
+        return {};
+
+    // Block start keys of every input, i.e. places where a reader can
+    // start without scanning from the front of a file
+    std::vector<std::string> keys;
 
-        if (merged.empty()) {
-            levels[level].erase(levels[level].begin());
-            return 0;
+    auto collect = [&](const SSTable& table) {
+        for (const SSTableIndexEntry& e : *table.getSparseIndex())
+            if (e.key > job.smallest)
+                keys.push_back(e.key);
+    };
+
+    for (const SSTable& t : job.upper) collect(t);
+    for (const SSTable& t : job.lower) collect(t);
+
+    std::sort(keys.begin(), keys.end());
+    keys.erase(std::unique(keys.begin(), keys.end()), keys.end());
+
+    const size_t parts = std::min(wanted, keys.size() + 1);
+
+    std::vector<std::string> bounds;
+    for (size_t i = 1; i < parts; ++i)
+        bounds.push_back(keys[i * keys.size() / parts]);
+
+    bounds.erase(std::unique(bounds.begin(), bounds.end()), bounds.end());
+    return bounds;
+}
+
+// Merges the part of `inputs` in [lo, hi) (empty = unbounded) into one
+// output file of `outputLevel`, or none if nothing survives
+static void runSubcompaction(const std::vector<const SSTable*>& inputs,
+                             const std::vector<RangeTombstone>& tombstones,
+                             const std::vector<SequenceNumber>& snapshots,
+                             const std::vector<KeyRange>& olderData,
+                             size_t outputLevel,
+                             const std::string& lo,
+                             const std::string& hi,
+                             RateLimiter* limiter,
+                             std::vector<SSTable>& outputs) {
+
+    // NEWEST FIRST (input order is merge priority)
+    std::vector<std::unique_ptr<SSTableIterator>> iters;
+    std::vector<Iterator*> children;
+
+    for (const SSTable* table : inputs) {
+        if (table->getMaxKey() < lo || (!hi.empty() && !(table->getMinKey() < hi)))
+            continue;
+
+        iters.push_back(std::make_unique<SSTableIterator>(*table, limiter, IOPriority::LOW));
+        children.push_back(iters.back().get());
+    }
+
+    // Range tombstones clipped to this slice so output files of
+    // neighbouring slices don't overlap
+    std::vector<RangeTombstone> clipped;
+
+    for (const RangeTombstone& t : tombstones) {
+        RangeTombstone c = t;
+        if (c.start < lo) c.start = lo;
+        if (!hi.empty() && hi < c.end) c.end = hi;
+        if (c.start < c.end)
+            clipped.push_back(std::move(c));
+    }
+
+    if (children.empty() && clipped.empty())
+        return;
+
+    FragmentedRangeTombstoneList rangeDels(clipped);
+
+    // Streams every version through the snapshot filter straight
+    // into the output file; keys and values are slices into the
+    // input read buffers
+    MergeIterator merged(children, MAX_SEQUENCE_NUMBER, true);
+    RangeIterator slice(&merged, lo, hi);
+    slice.seek(lo);
+
+    CompactionIterator live(slice, snapshots, true, &rangeDels, &olderData);
+
+    // Several compactions can finish within the same second, and the
+    // counter restarts with the process while older outputs stay live
+    static std::atomic<uint64_t> outputCounter{0};
+
+    std::string outPath;
+    do {
+        outPath =
+            "data/L" + std::to_string(outputLevel) + "_" +
+            std::to_string(std::time(nullptr)) + "_" +
+            std::to_string(outputCounter++) + ".dat";
+    } while (std::filesystem::exists(outPath));
+
+    SSTable writer(outPath, 10000, 3);
+    writer.setRateLimiter(limiter, IOPriority::LOW);
+
+    FragmentedRangeTombstoneList outDels = live.outputRangeTombstones();
+    writer.writeToDisk(live, &outDels);
+
+    // Everything was deleted: keep no output
+    if (writer.isEmpty()) {
+        std::remove(outPath.c_str());
+        return;
+    }
+
+    outputs.push_back(SSTable(outPath, 10000, 3));
+}
+
+void Compaction::execute(CompactionJob& job,
+                         const std::vector<SequenceNumber>& snapshots){
+
+    const size_t level = job.level;
+    const size_t outputLevel = job.outputLevel;
+    const SSTable& candidate = job.upper.front();
+
+    if (stats && job.tombstoneTriggered)
+        stats->recordTick(Ticker::TOMBSTONE_COMPACTIONS);
+
+    if (job.trivialMove) {
+        std::cout << "Moving " << candidate.getFilePath()
+                  << " Level " << level << " -> " << outputLevel
+                  << " (trivial move)" << std::endl;
+
+        job.outputs = job.upper;
+        job.bytesWritten = 0;
+        job.subcompactions = 0;
+
+        if (stats) {
+            stats->recordLevel(outputLevel, LevelCounter::TRIVIAL_MOVE_BYTES, candidate.getFileSize());
+            stats->recordTick(Ticker::TRIVIAL_MOVES);
+            stats->recordTick(Ticker::TRIVIAL_MOVE_BYTES, candidate.getFileSize());
         }
+        return;
+    }
+
+    const auto startTime = std::chrono::steady_clock::now();
+
+    // Next-level files entirely under the candidate's range
+    // tombstones are deleted without being read or rewritten
+    std::vector<bool> covered(job.lower.size(), false);
 
-        std::string outPath =
-            "data/L" + std::to_string(level + 1) + "_" +
-            std::to_string(std::time(nullptr)) + ".dat";
+    if (const FragmentedRangeTombstoneList* dels =
+            candidate.getRangeTombstones()) {
 
-        SSTable writer(outPath, 10000, 3);
-        writer.writeToDisk(merged);
+        const SequenceNumber newestSnapshot = snapshots.empty()
+            ? 0
+            : *std::max_element(snapshots.begin(), snapshots.end());
 
-        SSTable reloaded(outPath, 10000, 3);
-        uint64_t compactionBytes = reloaded.getFileSize();
+        for (size_t i = 0; i < job.lower.size(); ++i) {
 
-        levels[level].erase(levels[level].begin());
+            const SSTable& t = job.lower[i];
 
-        std::sort(overlapIndexes.rbegin(),
-                  overlapIndexes.rend());
+            // No snapshot may still see any of its versions
+            if (!snapshots.empty() &&
+                newestSnapshot >= t.getProperties().smallestSeq)
+                continue;
 
-        for (size_t idx : overlapIndexes) {
-            levels[level + 1].erase(
-                levels[level + 1].begin() + idx
-            );
+            if (dels->coversRange(t.getMinKey(), t.getMaxKey(),
+                                  t.getProperties().largestSeq))
+                covered[i] = true;
         }
+    }
+
+    // NEWEST FIRST (input order is merge priority)
+    std::vector<const SSTable*> inputs;
+
+    // Range tombstones of every input, re-fragmented per slice
+    std::vector<RangeTombstone> tombstones;
+
+    uint64_t upperBytes = 0;
+
+    for (const SSTable& t : job.upper) {
+        inputs.push_back(&t);
+        upperBytes += t.getFileSize();
+
+        if (auto dels = t.getRangeTombstones())
+            dels->appendTo(tombstones);
+    }
 
-        auto& nextLevel = levels[level + 1];
+    uint64_t lowerBytes = 0;
 
-        nextLevel.push_back(reloaded);
+    for (size_t i = 0; i < job.lower.size(); ++i) {
+        if (covered[i]) continue;
 
-        std::sort(nextLevel.begin(),
-                  nextLevel.end(),
-                  [](const SSTable& a,
-                     const SSTable& b){
-            return a.getMinKey() < b.getMinKey();
-        });
+        inputs.push_back(&job.lower[i]);
+        lowerBytes += job.lower[i].getFileSize();
 
-        return compactionBytes;
+        if (auto dels = job.lower[i].getRangeTombstones())
+            dels->appendTo(tombstones);
     }
 
-    return 0;
-}
\ No newline at end of file
+    // Split at block boundaries of the inputs; each slice is merged on
+    // its own thread into its own file, and all of them are installed
+    // together
+    const std::vector<std::string> bounds =
+        subcompactionBoundaries(job, upperBytes + lowerBytes);
+
+    const size_t parts = bounds.size() + 1;
+    std::vector<std::vector<SSTable>> sliceOutputs(parts);
+
+    auto runSlice = [&](size_t i) {
+        const std::string lo = i == 0 ? std::string() : bounds[i - 1];
+        const std::string hi = i + 1 == parts ? std::string() : bounds[i];
+
+        runSubcompaction(inputs, tombstones, snapshots, job.olderData,
+                         outputLevel, lo, hi, rateLimiter, sliceOutputs[i]);
+    };
+
+    std::cout << "Compacting Level "
+              << level << " -> " << outputLevel
+              << " (overlap files: "
+              << job.lower.size()
+              << ", subcompactions: "
+              << parts
+              << ")" << std::endl;
+
+    std::vector<std::thread> workers;
+    for (size_t i = 1; i < parts; ++i)
+        workers.emplace_back(runSlice, i);
+
+    runSlice(0);
+
+    for (auto& w : workers)
+        w.join();
+
+    job.subcompactions = parts;
+    job.bytesWritten = 0;
+
+    for (auto& slice : sliceOutputs) {
+        for (SSTable& table : slice) {
+            job.bytesWritten += table.getFileSize();
+            job.outputs.push_back(std::move(table));
+        }
+    }
+
+    if (stats) {
+        const uint64_t nanos = std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now() - startTime).count();
+
+        stats->recordLevel(outputLevel, LevelCounter::COMPACTION_READ_UPPER, upperBytes);
+        stats->recordLevel(outputLevel, LevelCounter::COMPACTION_READ_LOWER, lowerBytes);
+        stats->recordLevel(outputLevel, LevelCounter::COMPACTION_WRITTEN, job.bytesWritten);
+        stats->recordLevel(outputLevel, LevelCounter::COMPACTIONS);
+        stats->recordLevel(outputLevel, LevelCounter::COMPACTION_NANOS, nanos);
+
+        stats->recordTick(Ticker::COMPACTIONS);
+        stats->recordTick(Ticker::SUBCOMPACTIONS, parts);
+        stats->recordTick(Ticker::COMPACTION_BYTES_READ, upperBytes + lowerBytes);
+        stats->recordTick(Ticker::COMPACTION_BYTES_WRITTEN, job.bytesWritten);
+        stats->measure(HistogramType::COMPACTION_LATENCY, nanos);
+        stats->measure(HistogramType::COMPACTION_BYTES, job.bytesWritten);
+    }
+}
+
+// =======================
+// INSTALL
+// =======================
+void Compaction::install(std::vector<std::vector<SSTable>>& levels,
+                         const CompactionJob& job) {
+
+    auto removeInputs = [](std::vector<SSTable>& level,
+                           const std::vector<SSTable>& inputs) {
+        for (const SSTable& in : inputs) {
+            auto it = std::find_if(level.begin(), level.end(),
+                                   [&](const SSTable& t) {
+                                       return t.getFilePath() == in.getFilePath();
+                                   });
+            if (it != level.end())
+                level.erase(it);
+        }
+    };
+
+    removeInputs(levels[job.level], job.upper);
+    removeInputs(levels[job.outputLevel], job.lower);
+
+    // Open iterators keep reading their own file handles.
+    // A moved file is its own output
+    if (!job.trivialMove) {
+        for (const SSTable& t : job.upper)
+            std::remove(t.getFilePath().c_str());
+        for (const SSTable& t : job.lower)
+            std::remove(t.getFilePath().c_str());
+    }
+
+    auto& nextLevel = levels[job.outputLevel];
+
+    nextLevel.insert(nextLevel.end(), job.outputs.begin(), job.outputs.end());
+
+    std::sort(nextLevel.begin(),
+              nextLevel.end(),
+              [](const SSTable& a,
+                 const SSTable& b){
+        return a.getMinKey() < b.getMinKey();
+    });
+
+    release(job);
+}
+
+void Compaction::release(const CompactionJob& job) {
+
+    for (const SSTable& t : job.upper)
+        reserved.erase(t.getFilePath());
+    for (const SSTable& t : job.lower)
+        reserved.erase(t.getFilePath());
+
+    inFlight.erase(std::remove(inFlight.begin(), inFlight.end(), &job),
+                   inFlight.end());
+}
+
+// =======================
+// SYNCHRONOUS
+// =======================
+uint64_t Compaction::run(std::vector<std::vector<SSTable>>& levels,
+                         const std::vector<SequenceNumber>& snapshots){
+
+    std::vector<double> scores(levels.size(), 0.0);
+
+    for (size_t level = 0; level + 1 < levels.size(); ++level) {
+        if (!levels[level].empty()) {
+            scores[level] = 1.0;
+            break;
+        }
+    }
+
+    std::unique_ptr<CompactionJob> job = pick(levels, scores);
+    if (!job)
+        return 0;
+
+    execute(*job, snapshots);
+    install(levels, *job);
+
+    return job->bytesWritten;
+}
@@ -0,0 +1,152 @@
+#include "CompactionIterator.h"
+#include "MemTable.h"
+
+#include <algorithm>
+#include <limits>
+
+CompactionIterator::CompactionIterator(Iterator& input,
+                                       std::vector<SequenceNumber> snapshots,
+                                       bool dropTombstones,
+                                       const FragmentedRangeTombstoneList* rangeDels,
+                                       const std::vector<KeyRange>* olderData)
+    : input(input),
+      snapshots(std::move(snapshots)),
+      dropTombstones(dropTombstones),
+      rangeDels(rangeDels && !rangeDels->empty() ? rangeDels : nullptr),
+      olderData(olderData && !olderData->empty() ? olderData : nullptr) {
+
+    std::sort(this->snapshots.begin(), this->snapshots.end());
+    findNext();
+}
+
+bool CompactionIterator::valid() const {
+    return input.valid();
+}
+
+void CompactionIterator::next() {
+    input.next();
+    findNext();
+}
+
+Slice CompactionIterator::key() const {
+    return input.key();
+}
+
+Slice CompactionIterator::value() const {
+    return input.value();
+}
+
+SequenceNumber CompactionIterator::sequence() const {
+    return input.sequence();
+}
+
+size_t CompactionIterator::stripeOf(SequenceNumber seq) const {
+    return std::lower_bound(snapshots.begin(), snapshots.end(), seq)
+           - snapshots.begin();
+}
+
+bool CompactionIterator::olderDataHas(const Slice& key) const {
+
+    if (!olderData)
+        return false;
+
+    // First range ending at or after key
+    auto it = std::lower_bound(olderData->begin(), olderData->end(), key,
+                               [](const KeyRange& r, const Slice& k) {
+                                   return Slice(r.largest) < k;
+                               });
+
+    return it != olderData->end() && Slice(it->smallest) <= key;
+}
+
+bool CompactionIterator::olderDataOverlaps(const std::string& start,
+                                           const std::string& end) const {
+
+    if (!olderData)
+        return false;
+
+    auto it = std::lower_bound(olderData->begin(), olderData->end(), start,
+                               [](const KeyRange& r, const std::string& k) {
+                                   return r.largest < k;
+                               });
+
+    return it != olderData->end() && it->smallest < end;
+}
+
+void CompactionIterator::findNext() {
+
+    while (input.valid()) {
+
+        const Slice key = input.key();
+        const size_t stripe = stripeOf(input.sequence());
+
+        if (!hasCurrentKey || key != Slice(currentKey)) {
+            currentKey.assign(key.data(), key.size());
+            hasCurrentKey = true;
+            lastStripe = std::numeric_limits<size_t>::max();
+        }
+
+        // A newer version in the same stripe hides this one from everyone
+        if (stripe == lastStripe) {
+            dropped++;
+            input.next();
+            continue;
+        }
+
+        lastStripe = stripe;
+
+        // Deleted by a range tombstone no snapshot sits in front of
+        if (rangeDels) {
+            SequenceNumber coveringSeq =
+                rangeDels->nextCoveringSeq(key, input.sequence());
+
+            if (coveringSeq != 0 && stripeOf(coveringSeq) == stripe) {
+                dropped++;
+                input.next();
+                continue;
+            }
+        }
+
+        // Oldest stripe: every older version is hidden by this tombstone
+        // too, so nothing needs it
+        if (dropTombstones && stripe == 0 &&
+            input.value() == MemTable::TOMBSTONE && !olderDataHas(key)) {
+            dropped++;
+            input.next();
+            continue;
+        }
+
+        return;
+    }
+}
+
+FragmentedRangeTombstoneList CompactionIterator::outputRangeTombstones() const {
+
+    if (!rangeDels)
+        return FragmentedRangeTombstoneList();
+
+    std::vector<RangeTombstone> kept;
+
+    for (const auto& frag : rangeDels->getFragments()) {
+
+        size_t prevStripe = std::numeric_limits<size_t>::max();
+
+        for (SequenceNumber s : frag.seqs) {   // newest first
+
+            const size_t stripe = stripeOf(s);
+
+            if (stripe == prevStripe)
+                continue;   // an older tombstone in the same stripe adds nothing
+
+            prevStripe = stripe;
+
+            if (dropTombstones && stripe == 0 &&
+                !olderDataOverlaps(frag.start, frag.end))
+                continue;
+
+            kept.push_back(RangeTombstone{frag.start, frag.end, s});
+        }
+    }
+
+    return FragmentedRangeTombstoneList(kept);
+}
@@ -2,6 +2,7 @@
 #include <fstream>
 #include <iostream>
 #include <filesystem>
+#include <algorithm>
 #include <nlohmann/json.hpp>
 
 using namespace std;
@@ -9,13 +10,28 @@ using json = nlohmann::json;
 
 ConfigManager::ConfigManager(const std::string& configPath)
     : configFilePath(configPath),
-      memTableMaxEntries(0),
+      memTableMaxBytes(4ULL * 1024 * 1024),
+      writeBufferManagerBytes(0),
       bloomFilterBitSize(0),
       bloomFilterHashCount(0),
       maxFilesPerLevel(0),
       compactionIntervalSeconds(5),
       l0Threshold(4),
-      flushIntervalSeconds(2)
+      flushIntervalSeconds(2),
+      flushThreads(1),
+      compactionThreads(2),
+      maxSubcompactions(1),
+      compactionPriority("min_overlapping_ratio"),
+      tombstoneRatioTrigger(0.5),
+      numLevels(4),
+      levelBaseBytes(100ULL * 1024 * 1024),
+      levelSizeMultiplier(10.0),
+      dynamicLevelBytes(false),
+      memoryBudgetBytes(0),
+      rowCacheRatio(0.25),
+      bulkLoad(false),
+      bulkLoadMemTableMaxBytes(256ULL * 1024 * 1024),
+      bulkLoadSortThreads(4)
 {}
 
 bool ConfigManager::load(){
@@ -34,9 +50,26 @@ bool ConfigManager::load(){
     compactionIntervalSeconds = 5;
     l0Threshold = 4;
     flushIntervalSeconds = 2;
+    flushThreads = 1;
+    compactionThreads = 2;
+    maxSubcompactions = 1;
+    compactionPriority = "min_overlapping_ratio";
+    tombstoneRatioTrigger = 0.5;
+    numLevels = 4;
+    levelBaseBytes = 100ULL * 1024 * 1024;
+    levelSizeMultiplier = 10.0;
+    dynamicLevelBytes = false;
+    memoryBudgetBytes = 0;
+    rowCacheRatio = 0.25;
+    bulkLoad = false;
+    bulkLoadMemTableMaxBytes = 256ULL * 1024 * 1024;
+    bulkLoadSortThreads = 4;
+    memTableMaxBytes = 4ULL * 1024 * 1024;
+    writeBufferManagerBytes = 0;
 
-    memTableMaxEntries =
-        config["storage"]["memtable"]["max_entries"];
+    if (config["storage"]["memtable"].contains("max_bytes"))
+        memTableMaxBytes =
+            config["storage"]["memtable"]["max_bytes"];
 
     sstableDirectory =
         config["storage"]["sstable"]["data_directory"];
@@ -69,6 +102,123 @@ bool ConfigManager::load(){
         if (comp.contains("l0_threshold"))
             l0Threshold =
                 comp["l0_threshold"];
+
+        if (comp.contains("max_subcompactions"))
+            maxSubcompactions =
+                comp["max_subcompactions"];
+
+        if (comp.contains("pick_priority"))
+            compactionPriority =
+                comp["pick_priority"];
+
+        if (comp.contains("tombstone_ratio_trigger"))
+            tombstoneRatioTrigger =
+                comp["tombstone_ratio_trigger"];
+
+        if (comp.contains("num_levels"))
+            numLevels =
+                comp["num_levels"];
+
+        if (comp.contains("level_base_bytes"))
+            levelBaseBytes =
+                comp["level_base_bytes"];
+
+        if (comp.contains("level_size_multiplier"))
+            levelSizeMultiplier =
+                comp["level_size_multiplier"];
+
+        if (comp.contains("dynamic_level_bytes"))
+            dynamicLevelBytes =
+                comp["dynamic_level_bytes"];
+    }
+
+    if(config.contains("background")){
+        auto bg = config["background"];
+
+        if (bg.contains("flush_threads"))
+            flushThreads = bg["flush_threads"];
+
+        if (bg.contains("compaction_threads"))
+            compactionThreads = bg["compaction_threads"];
+    }
+
+    if(config.contains("write_buffer_manager")){
+        auto wbm = config["write_buffer_manager"];
+
+        if (wbm.contains("buffer_size"))
+            writeBufferManagerBytes = wbm["buffer_size"];
+    }
+
+    if(config.contains("memory")){
+        auto mem = config["memory"];
+
+        if (mem.contains("budget_bytes"))
+            memoryBudgetBytes = mem["budget_bytes"];
+
+        if (mem.contains("row_cache_ratio"))
+            rowCacheRatio = mem["row_cache_ratio"];
+    }
+
+    if(config.contains("bulk_load")){
+        auto bl = config["bulk_load"];
+
+        if (bl.contains("enabled"))
+            bulkLoad = bl["enabled"];
+
+        if (bl.contains("memtable_max_bytes"))
+            bulkLoadMemTableMaxBytes = bl["memtable_max_bytes"];
+
+        if (bl.contains("sort_threads"))
+            bulkLoadSortThreads = bl["sort_threads"];
+    }
+
+    writeControllerOptions = WriteControllerOptions();
+    writeControllerOptions.l0SlowdownTrigger = 5 * l0Threshold;
+    writeControllerOptions.l0StopTrigger = 9 * l0Threshold;
+
+    if(config.contains("write_controller")){
+        auto wc = config["write_controller"];
+        WriteControllerOptions& o = writeControllerOptions;
+
+        if (wc.contains("l0_slowdown_trigger"))
+            o.l0SlowdownTrigger = wc["l0_slowdown_trigger"];
+
+        if (wc.contains("l0_stop_trigger"))
+            o.l0StopTrigger = wc["l0_stop_trigger"];
+
+        if (wc.contains("immutable_slowdown_trigger"))
+            o.immutableSlowdownTrigger = wc["immutable_slowdown_trigger"];
+
+        if (wc.contains("immutable_stop_trigger"))
+            o.immutableStopTrigger = wc["immutable_stop_trigger"];
+
+        if (wc.contains("pending_compaction_slowdown_bytes"))
+            o.pendingCompactionSlowdownBytes = wc["pending_compaction_slowdown_bytes"];
+
+        if (wc.contains("pending_compaction_stop_bytes"))
+            o.pendingCompactionStopBytes = wc["pending_compaction_stop_bytes"];
+
+        if (wc.contains("delayed_write_rate"))
+            o.delayedWriteRate = wc["delayed_write_rate"];
+    }
+
+    rateLimiterOptions = RateLimiterOptions();
+
+    if(config.contains("rate_limiter")){
+        auto rl = config["rate_limiter"];
+        RateLimiterOptions& o = rateLimiterOptions;
+
+        if (rl.contains("bytes_per_second"))
+            o.bytesPerSecond = rl["bytes_per_second"];
+
+        if (rl.contains("auto_tune"))
+            o.autoTune = rl["auto_tune"];
+
+        if (rl.contains("min_bytes_per_second"))
+            o.minBytesPerSecond = rl["min_bytes_per_second"];
+
+        if (rl.contains("max_bytes_per_second"))
+            o.maxBytesPerSecond = rl["max_bytes_per_second"];
     }
 
     if(config.contains("flush")){
@@ -82,8 +232,12 @@ bool ConfigManager::load(){
     return true;
 }
 
-int ConfigManager::getMemTableMaxEntries() const{
-    return memTableMaxEntries;
+size_t ConfigManager::getMemTableMaxBytes() const{
+    return memTableMaxBytes;
+}
+
+size_t ConfigManager::getWriteBufferManagerBytes() const{
+    return writeBufferManagerBytes;
 }
 
 int ConfigManager::getBloomFilterBitSize() const {
@@ -112,4 +266,68 @@ int ConfigManager::getL0Threshold() const{
 
 int ConfigManager::getFlushInterval() const{
     return flushIntervalSeconds;
+}
+
+const WriteControllerOptions& ConfigManager::getWriteControllerOptions() const{
+    return writeControllerOptions;
+}
+
+int ConfigManager::getFlushThreads() const{
+    return flushThreads;
+}
+
+int ConfigManager::getCompactionThreads() const{
+    return compactionThreads;
+}
+
+int ConfigManager::getMaxSubcompactions() const{
+    return maxSubcompactions;
+}
+
+std::string ConfigManager::getCompactionPriority() const{
+    return compactionPriority;
+}
+
+double ConfigManager::getTombstoneRatioTrigger() const{
+    return tombstoneRatioTrigger;
+}
+
+int ConfigManager::getNumLevels() const{
+    return numLevels;
+}
+
+uint64_t ConfigManager::getLevelBaseBytes() const{
+    return levelBaseBytes;
+}
+
+double ConfigManager::getLevelSizeMultiplier() const{
+    return levelSizeMultiplier;
+}
+
+bool ConfigManager::getDynamicLevelBytes() const{
+    return dynamicLevelBytes;
+}
+
+size_t ConfigManager::getMemoryBudgetBytes() const{
+    return memoryBudgetBytes;
+}
+
+double ConfigManager::getRowCacheRatio() const{
+    return std::min(1.0, std::max(0.0, rowCacheRatio));
+}
+
+bool ConfigManager::getBulkLoad() const{
+    return bulkLoad;
+}
+
+size_t ConfigManager::getBulkLoadMemTableMaxBytes() const{
+    return bulkLoadMemTableMaxBytes;
+}
+
+int ConfigManager::getBulkLoadSortThreads() const{
+    return bulkLoadSortThreads;
+}
+
+const RateLimiterOptions& ConfigManager::getRateLimiterOptions() const{
+    return rateLimiterOptions;
 }
\ No newline at end of file
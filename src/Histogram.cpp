@@ -0,0 +1,177 @@
+#include "Histogram.h"
+
+#include <limits>
+#include <algorithm>
+
+// =======================
+// BUCKET LAYOUT
+// =======================
+size_t Histogram::bucketFor(uint64_t value) {
+
+    if (value < 64)
+        return static_cast<size_t>(value);
+
+    // Keep the top 6 significant bits: [32, 63] after the shift
+    const int msb = 63 - __builtin_clzll(value);
+    const int shift = msb - 5;
+    const uint64_t top = value >> shift;
+
+    return 64 + static_cast<size_t>(shift - 1) * 32 + static_cast<size_t>(top - 32);
+}
+
+uint64_t Histogram::bucketLowerBound(size_t bucket) {
+
+    if (bucket < 64)
+        return bucket;
+
+    const size_t shift = (bucket - 64) / 32 + 1;
+    const uint64_t top = (bucket - 64) % 32 + 32;
+
+    return top << shift;
+}
+
+uint64_t Histogram::bucketUpperBound(size_t bucket) {
+
+    if (bucket < 64)
+        return bucket;
+
+    if (bucket + 1 >= BUCKETS)
+        return std::numeric_limits<uint64_t>::max();
+
+    return bucketLowerBound(bucket + 1) - 1;
+}
+
+// =======================
+// RECORDING
+// =======================
+Histogram::Histogram() {
+    reset();
+}
+
+void Histogram::reset() {
+    for (auto& c : counts)
+        c.store(0, std::memory_order_relaxed);
+
+    count.store(0, std::memory_order_relaxed);
+    sum.store(0, std::memory_order_relaxed);
+    min.store(std::numeric_limits<uint64_t>::max(), std::memory_order_relaxed);
+    max.store(0, std::memory_order_relaxed);
+}
+
+void Histogram::record(uint64_t value) {
+
+    counts[bucketFor(value)].fetch_add(1, std::memory_order_relaxed);
+    count.fetch_add(1, std::memory_order_relaxed);
+    sum.fetch_add(value, std::memory_order_relaxed);
+
+    uint64_t cur = min.load(std::memory_order_relaxed);
+    while (value < cur &&
+           !min.compare_exchange_weak(cur, value, std::memory_order_relaxed)) {}
+
+    cur = max.load(std::memory_order_relaxed);
+    while (value > cur &&
+           !max.compare_exchange_weak(cur, value, std::memory_order_relaxed)) {}
+}
+
+void Histogram::add(const HistogramSnapshot& other) {
+
+    if (other.count == 0)
+        return;
+
+    const size_t n = std::min(other.counts.size(), BUCKETS);
+    for (size_t i = 0; i < n; i++)
+        if (other.counts[i])
+            counts[i].fetch_add(other.counts[i], std::memory_order_relaxed);
+
+    count.fetch_add(other.count, std::memory_order_relaxed);
+    sum.fetch_add(other.sum, std::memory_order_relaxed);
+
+    uint64_t cur = min.load(std::memory_order_relaxed);
+    while (other.min < cur &&
+           !min.compare_exchange_weak(cur, other.min, std::memory_order_relaxed)) {}
+
+    cur = max.load(std::memory_order_relaxed);
+    while (other.max > cur &&
+           !max.compare_exchange_weak(cur, other.max, std::memory_order_relaxed)) {}
+}
+
+HistogramSnapshot Histogram::snapshot() const {
+
+    HistogramSnapshot s;
+    s.counts.resize(BUCKETS);
+
+    for (size_t i = 0; i < BUCKETS; i++)
+        s.counts[i] = counts[i].load(std::memory_order_relaxed);
+
+    s.count = count.load(std::memory_order_relaxed);
+    s.sum = sum.load(std::memory_order_relaxed);
+    s.min = s.count ? min.load(std::memory_order_relaxed) : 0;
+    s.max = max.load(std::memory_order_relaxed);
+
+    return s;
+}
+
+// =======================
+// SNAPSHOT QUERIES
+// =======================
+void HistogramSnapshot::merge(const HistogramSnapshot& other) {
+
+    if (other.count == 0)
+        return;
+
+    if (counts.size() < other.counts.size())
+        counts.resize(other.counts.size());
+
+    for (size_t i = 0; i < other.counts.size(); i++)
+        counts[i] += other.counts[i];
+
+    min = count ? std::min(min, other.min) : other.min;
+    max = std::max(max, other.max);
+    count += other.count;
+    sum += other.sum;
+}
+
+HistogramSnapshot HistogramSnapshot::since(const HistogramSnapshot& earlier) const {
+
+    HistogramSnapshot d;
+    d.counts.resize(counts.size());
+
+    size_t lo = counts.size(), hi = 0;
+
+    for (size_t i = 0; i < counts.size(); i++) {
+        uint64_t before = i < earlier.counts.size() ? earlier.counts[i] : 0;
+        d.counts[i] = counts[i] - before;
+
+        if (d.counts[i]) {
+            lo = std::min(lo, i);
+            hi = i;
+        }
+    }
+
+    d.count = count - earlier.count;
+    d.sum = sum - earlier.sum;
+
+    if (d.count) {
+        d.min = std::max(min, Histogram::bucketLowerBound(lo));
+        d.max = std::min(max, Histogram::bucketUpperBound(hi));
+    }
+
+    return d;
+}
+
+uint64_t HistogramSnapshot::percentile(double p) const {
+
+    if (count == 0)
+        return 0;
+
+    const double target = count * (p / 100.0);
+    uint64_t seen = 0;
+
+    for (size_t i = 0; i < counts.size(); i++) {
+        seen += counts[i];
+        if (seen >= target && counts[i])
+            return std::min(Histogram::bucketUpperBound(i), max);
+    }
+
+    return max;
+}
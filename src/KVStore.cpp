@@ -9,25 +9,102 @@
 #include <future>
 #include <atomic>
 #include <mutex>
+#include <cstring>
+#include <cstdio>
 
 #include "MemTable.h"
+#include "MemTableIterator.h"
+#include "SSTableIterator.h"
+#include "MergeIterator.h"
+#include "CompactionIterator.h"
 #include "Logger.h"
 #include "TableCache.h"
 
 static std::chrono::steady_clock::time_point benchmarkStart;
 
+namespace {
+
+SSTableMeta metaOf(const SSTable& table) {
+    return SSTableMeta(table.getFilePath(), table.getMinKey(),
+                       table.getMaxKey(), table.getFileSize(),
+                       table.getGlobalSequence());
+}
+
+// User-facing iterator: merges every source as of one snapshot and hides
+// deleted keys, including those under a range tombstone. Owns its sources
+// and keeps the MemTables it reads alive, so concurrent writers and
+// flushes don't disturb it.
+class DBIterator : public Iterator {
+public:
+    DBIterator(std::vector<std::shared_ptr<const SkipList>> mems,
+               std::vector<std::unique_ptr<Iterator>> sources,
+               const std::vector<RangeTombstone>& tombstones,
+               SequenceNumber snapshot)
+        : mems(std::move(mems)),
+          sources(std::move(sources)),
+          rangeDels(tombstones),
+          snapshot(snapshot) {
+
+        std::vector<Iterator*> children;
+        for (auto& s : this->sources)
+            children.push_back(s.get());
+
+        merged = std::make_unique<MergeIterator>(children, snapshot);
+        skipDeleted();
+    }
+
+    bool valid() const override { return merged->valid(); }
+
+    void next() override {
+        merged->next();
+        skipDeleted();
+    }
+
+    Slice key() const override { return merged->key(); }
+    Slice value() const override { return merged->value(); }
+    SequenceNumber sequence() const override { return merged->sequence(); }
+
+    void seek(const Slice& target) override {
+        merged->seek(target);
+        skipDeleted();
+    }
+
+private:
+    void skipDeleted() {
+        while (merged->valid() && isDeleted())
+            merged->next();
+    }
+
+    bool isDeleted() const {
+        if (merged->value() == MemTable::TOMBSTONE)
+            return true;
+
+        return !rangeDels.empty() &&
+               rangeDels.maxCoveringSeq(merged->key(), snapshot) > merged->sequence();
+    }
+
+    std::vector<std::shared_ptr<const SkipList>> mems;
+    std::vector<std::unique_ptr<Iterator>> sources;
+    FragmentedRangeTombstoneList rangeDels;
+    SequenceNumber snapshot;
+    std::unique_ptr<MergeIterator> merged;
+};
+
+}
+
 // =======================
 void KVStore::loadStats() {
-    std::ifstream in("metadata/stats.dat", std::ios::binary);
-    if (!in.is_open()) return;
-    in.read(reinterpret_cast<char*>(&stats), sizeof(stats));
+    if (!std::filesystem::exists("metadata/stats.dat"))
+        return;
+
+    // Files from before the versioned format are not readable; start over
+    if (!stats.loadFrom("metadata/stats.dat"))
+        LOG_INFO("Ignoring unreadable metadata/stats.dat");
 }
 
 void KVStore::saveStats() const {
-    std::ofstream out("metadata/stats.dat",
-                      std::ios::binary | std::ios::trunc);
-    out.write(reinterpret_cast<const char*>(&stats),
-              sizeof(stats));
+    if (!stats.saveTo("metadata/stats.dat"))
+        LOG_ERROR("Failed to write metadata/stats.dat");
 }
 
 // =======================
@@ -35,15 +112,17 @@ KVStore::KVStore(const std::string& configPath,
                  const std::string& strategy)
 
     : configManager(configPath),
+      writeBufferManager(WriteBufferManager::global()),
       memTable(nullptr),
       wal("metadata/wal.log"),
+      lastSequence(0),
       levels(),
       compaction(
           strategy == "tiering"
               ? Compaction::Strategy::TIERED
               : Compaction::Strategy::LEVEL,
           0),
-      manifest("metadata/manifest.txt"),
+      manifest("metadata/MANIFEST", "metadata/manifest.txt"),
       sstableCounter(0),
       tableCache(50),
       cache(10000),
@@ -54,28 +133,109 @@ KVStore::KVStore(const std::string& configPath,
         throw std::runtime_error("Config load failed");
     }
 
+    writeController.setOptions(configManager.getWriteControllerOptions());
+    rateLimiter.setOptions(configManager.getRateLimiterOptions());
+
     loadStats();
-    benchmarkStart = std::chrono::steady_clock::now();
+    compaction.setStatistics(&stats);
+    compaction.setMaxSubcompactions(std::max(1, configManager.getMaxSubcompactions()));
+    compaction.setRateLimiter(&rateLimiter);
+
+    compaction.setTombstoneRatioTrigger(configManager.getTombstoneRatioTrigger());
 
-    memTable = new MemTable(configManager.getMemTableMaxEntries());
-    wal.replay(*memTable);
+    Compaction::Priority priority;
+    if (Compaction::parsePriority(configManager.getCompactionPriority(), priority))
+        compaction.setPriority(priority);
+    else
+        LOG_ERROR("Unknown compaction pick_priority: " + configManager.getCompactionPriority());
+    benchmarkStart = std::chrono::steady_clock::now();
 
-    levels.resize(MAX_LEVELS);
+    manifest.setLevelOptions(configManager.getNumLevels(),
+                             configManager.getLevelBaseBytes(),
+                             configManager.getLevelSizeMultiplier(),
+                             configManager.getDynamicLevelBytes());
     loadFromManifest();
 
+    // Continue numbering after everything already on disk
+    SequenceNumber last = manifest.getLastSequence();
+    for (const auto& level : levels)
+        for (const auto& table : level)
+            last = std::max(last, table.getProperties().largestSeq);
+
+    // Logs sealed before a restart belong to the MemTable they replay into
+    recoveredLogs = wal.sealedLogs();
+
+    // MemTables take half of an overall memory budget unless told otherwise
+    if (configManager.getWriteBufferManagerBytes() > 0)
+        writeBufferManager.setBufferSize(configManager.getWriteBufferManagerBytes());
+    else if (configManager.getMemoryBudgetBytes() > 0)
+        writeBufferManager.setBufferSize(configManager.getMemoryBudgetBytes() / 2);
+
+    // Under a budget the caches are sized in bytes only
+    if (configManager.getMemoryBudgetBytes() > 0) {
+        cache.setCapacity(std::numeric_limits<size_t>::max());
+        blockCache.setCapacity(std::numeric_limits<size_t>::max());
+    }
+
+    memTable = newMemTable();
+    wal.replay(*memTable, last);
+    lastSequence = last;
+
+    updateWriteController();
+
+    maxCompactions = std::max(1, configManager.getCompactionThreads());
+
+    flushPool = std::make_unique<ThreadPool>(
+        "flush", std::max(1, configManager.getFlushThreads()));
+    compactionPool = std::make_unique<ThreadPool>("compaction", maxCompactions);
+
     running = true;
-    flushThread = std::thread(&KVStore::backgroundFlush, this);
+    writeBufferManager.registerClient(this);
+
+    if (configManager.getBulkLoad()) {
+        bulkLoading = true;
+        compactionDeferred = true;
+
+        LOG_INFO("Bulk load: WAL disabled, compaction deferred");
+
+        // What the WAL replayed goes out first; it is all the log holds
+        std::lock_guard<std::mutex> lock(writeMutex);
+        sealMemTable();
+
+        std::lock_guard<std::mutex> memLock(memTableMutex);
+        if (!memTable->isAppendOnly())
+            memTable = newMemTable();
+    }
+
+    rebalanceMemory();
+    maybeScheduleCompaction();
 }
 
 // =======================
 KVStore::~KVStore() {
 
+    writeBufferManager.unregisterClient(this);
+
+    // Bulk-loaded MemTables have no WAL behind them
+    if (bulkLoading && flushPool)
+        flush();
+
     running = false;
-    saveStats();
+    writeController.shutdown();
+
+    // Unflushed MemTables are rebuilt from their WAL files on restart,
+    // so the records still buffered in the WAL go to disk first
+    if (flushPool) flushPool->shutdown();
+    if (compactionPool) compactionPool->shutdown();
 
-    if (flushThread.joinable()) flushThread.join();
+    wal.flush();
 
-    delete memTable;
+    {
+        std::lock_guard<std::mutex> lock(memTableMutex);
+        flushInstalled.notify_all();
+    }
+
+    saveStats();
 }
 
 // =======================
@@ -84,48 +244,128 @@ void KVStore::loadFromManifest() {
     manifest.load();
     auto allLevels = manifest.getLevels();
 
+    // Files deeper than num_levels keep their level
+    levels.resize(allLevels.size());
+
     for (size_t level = 0; level < allLevels.size(); ++level) {
         for (const auto& meta : allLevels[level]) {
 
+            // Crashed before the edit removing it reached the log
+            if (!std::filesystem::exists(meta.filePath)) {
+                LOG_ERROR("Manifest lists missing SSTable: " + meta.filePath);
+                continue;
+            }
+
             SSTable table(
                 meta.filePath,
                 configManager.getBloomFilterBitSize(),
                 configManager.getBloomFilterHashCount()
             );
 
+            table.setGlobalSequence(meta.globalSeq);
             table.setStatsHook(this);
+            table.setBlockCache(&blockCache);
             levels[level].push_back(table);
-            ++sstableCounter;
+        }
+
+        if (level > 0) {
+            std::sort(levels[level].begin(), levels[level].end(),
+                      [](const SSTable& a, const SSTable& b) {
+                          return a.getMinKey() < b.getMinKey();
+                      });
         }
     }
+
+    // Never reuse the name of a file still on disk, listed or not
+    uint64_t next = manifest.getNextFileNumber();
+
+    std::error_code ec;
+    for (const auto& entry : std::filesystem::directory_iterator(
+             configManager.getSSTableDirectory(), ec)) {
+
+        const std::string name = entry.path().filename().string();
+
+        if (name.rfind("sstable_", 0) != 0)
+            continue;
+
+        try {
+            next = std::max<uint64_t>(next, std::stoull(name.substr(8)) + 1);
+        } catch (const std::exception&) {
+        }
+    }
+
+    sstableCounter = static_cast<int>(next);
+}
+
+std::shared_ptr<MemTable> KVStore::activeMemTable() const {
+    std::lock_guard<std::mutex> lock(memTableMutex);
+    return memTable;
+}
+
+size_t KVStore::activeMemTableBytes() const {
+    return activeMemTable()->getMemoryUsage();
+}
+
+void KVStore::requestFlush() {
+    std::lock_guard<std::mutex> lock(writeMutex);
+
+    if (!running)
+        return;
+
+    stats.recordTick(Ticker::WRITE_BUFFER_MANAGER_FLUSHES);
+    sealMemTable();
+}
+
+std::shared_ptr<MemTable> KVStore::newMemTable() const {
+    if (bulkLoading)
+        return std::make_shared<MemTable>(configManager.getBulkLoadMemTableMaxBytes(),
+                                          true, &writeBufferManager);
+
+    return std::make_shared<MemTable>(configManager.getMemTableMaxBytes(),
+                                      false, &writeBufferManager);
+}
+
+std::vector<std::shared_ptr<MemTable>> KVStore::memTables() const {
+    std::lock_guard<std::mutex> lock(memTableMutex);
+
+    std::vector<std::shared_ptr<MemTable>> mems;
+    mems.reserve(1 + immutables.size());
+
+    mems.push_back(memTable);
+    for (auto it = immutables.rbegin(); it != immutables.rend(); ++it)
+        mems.push_back((*it)->mem);
+
+    return mems;
 }
 
 void KVStore::put(const std::string& key,
                   const std::string& value) {
 
-    //std::cout << "[PUT] Start: " << key << "\n";
-    stats.totalPuts++;
+    StopWatch timer(stats, HistogramType::PUT_LATENCY);
 
-    //std::cout << "[PUT] WAL write...\n";
-    wal.logPut(key, value);
-   // std::cout << "[PUT] WAL done\n";
+    // Before writeMutex: the store asked to flush may be this one
+    writeBufferManager.maybeFlush();
+    maybeRebalanceMemory(key.size() + value.size());
+    writeController.delayWrite(key.size() + value.size(), stats);
 
-    //std::cout << "[PUT] MemTable insert...\n";
-    memTable->put(key, value);
-   // std::cout << "[PUT] MemTable done\n";
+    stats.recordTick(Ticker::PUTS);
+    stats.recordTick(Ticker::BYTES_WRITTEN, key.size() + value.size());
 
-    //std::cout << "[PUT] Cache put...\n";
-    cache.put(key, value);
-    //std::cout << "[PUT] Cache done\n";
+    std::lock_guard<std::mutex> lock(writeMutex);
 
-   // std::cout << "[PUT] Full check...\n";
-    if (memTable->isFull()) {
-        //std::cout << "[PUT] MemTable full -> flushing...\n";
-        flushMemTable();
-        //std::cout << "[PUT] Flush done\n";
-    }
+    // Published only after the MemTable insert so a snapshot
+    // never covers a write that is still in flight
+    const SequenceNumber seq = lastSequence.load() + 1;
+
+    if (!bulkLoading)
+        wal.logPut(key, value, seq);
+    memTable->put(key, value, seq);
+    lastSequence.store(seq);
+
+    cache.put(key, value);
 
-//    std::cout << "[PUT] End: " << key << "\n";
+    if (memTable->isFull())
+        sealMemTable();
 }
 
 // =======================
@@ -242,71 +482,152 @@ void KVStore::put(const std::string& key,
 // }
 
 bool KVStore::get(const std::string& key, std::string& value) {
-    value.clear();
-    stats.totalGets++;
+    return get(ReadOptions(), key, value);
+}
 
-    // LRU cache
-    if (cache.get(key, value)) {
-        stats.cacheHits++;
-        return true;
+bool KVStore::get(const ReadOptions& options,
+                  const std::string& key,
+                  std::string& value) {
+
+    PinnableSlice pinned;
+
+    if (!get(options, key, pinned)) {
+        value.clear();
+        return false;
+    }
+
+    value.assign(pinned.data(), pinned.size());
+    return true;
+}
+
+bool KVStore::get(const std::string& key,
+                  char* buffer,
+                  size_t bufferSize,
+                  size_t& valueSize) {
+
+    PinnableSlice pinned;
+
+    if (!get(key, pinned)) {
+        valueSize = 0;
+        return false;
+    }
+
+    valueSize = pinned.size();
+    std::memcpy(buffer, pinned.data(), std::min(bufferSize, valueSize));
+    return true;
+}
+
+bool KVStore::get(const std::string& key, PinnableSlice& value) {
+    return get(ReadOptions(), key, value);
+}
+
+bool KVStore::get(const ReadOptions& options,
+                  const std::string& key,
+                  PinnableSlice& value) {
+    value.reset();
+    StopWatch timer(stats, HistogramType::GET_LATENCY);
+    stats.recordTick(Ticker::GETS);
+
+    const bool profiled = options.perfLevel != PerfLevel::DISABLED;
+    PerfLevelScope perfScope(profiled ? options.perfLevel : tlsPerfLevel);
+    if (profiled)
+        getPerfContext().reset();
+
+    PERF_TIMER_GUARD(getNanos);
+
+    const bool latest = options.snapshot == nullptr;
+    const SequenceNumber snapshot =
+        latest ? MAX_SEQUENCE_NUMBER : options.snapshot->getSequenceNumber();
+
+    // A write landing during the lookup makes the result unsafe to cache
+    const SequenceNumber seqAtStart = lastSequence.load();
+
+    // LRU cache (shares the cached pin); it only knows latest values
+    if (latest) {
+        PERF_TIMER_GUARD(rowCacheNanos);
+
+        if (cache.get(key, value)) {
+            stats.recordTick(Ticker::CACHE_HITS);
+            return true;
+        }
+
+        stats.recordTick(Ticker::CACHE_MISSES);
     }
 
-    stats.cacheMisses++;
+    // Newest range tombstone over `key` seen so far; any version older
+    // than it is deleted
+    SequenceNumber rangeDelSeq = 0;
+    SequenceNumber foundSeq = 0;
+
+    // MemTables, newest first
+    PerfTimer memtableTimer(&PerfContext::memtableNanos);
+
+    for (const std::shared_ptr<MemTable>& mem : memTables()) {
+
+        rangeDelSeq = std::max(rangeDelSeq, mem->maxCoveringTombstone(key, snapshot));
 
-    // MemTable
-    std::string memVal;
-    if (memTable->get(key, memVal)) {
-        if (memVal == MemTable::TOMBSTONE)
+        std::string memVal;
+        if (!mem->get(key, memVal, snapshot, &foundSeq))
+            continue;
+
+        memtableTimer.stop();
+        PERF_COUNTER_ADD(memtableHits, 1);
+
+        if (memVal == MemTable::TOMBSTONE || foundSeq < rangeDelSeq)
             return false;
 
-        value = memVal;
-        cache.put(key, value);
+        value.pinSelf(std::move(memVal));
+        if (latest) cache.putIfUnchanged(key, value, seqAtStart, lastSequence);
         return true;
     }
 
+    memtableTimer.stop();
+
+    std::shared_lock<std::shared_mutex> lock(levelsMutex);
+
     // LEVEL-WISE SEARCH (sequential, stable)
     for (size_t level = 0; level < levels.size(); level++) {
 
-        for (auto& tableRef : levels[level]) {
+        const size_t count = levels[level].size();
+
+        for (size_t i = 0; i < count; i++) {
+
+            // L0 files overlap: newest (last flushed) must win
+            const SSTable& tableRef =
+                levels[level][level == 0 ? count - 1 - i : i];
 
             if (key < tableRef.getMinKey() || key > tableRef.getMaxKey())
                 continue;
 
-            // block cache
-            std::string blockKey = tableRef.getFilePath() + "_" + key;
-            std::string cachedValue;
+            PERF_COUNTER_ADD(sstablesTouched, 1);
 
-            if (blockCache.get(blockKey, cachedValue)) {
-                value = cachedValue;
-                cache.put(key, value);
-                return true;
-            }
+            // Range tombstones apply even when the bloom filter rejects
+            rangeDelSeq = std::max(rangeDelSeq,
+                                   tableRef.maxCoveringTombstone(key, snapshot));
 
             // bloom
             if (!tableRef.mightContain(key))
                 continue;
 
-            std::string val;
-            GetResult res;
+            // Data blocks come from the shared block cache; the
+            // result references the block instead of copying out of it
+            uint64_t bytesRead = 0;
+            GetResult res = tableRef.get(key, value, snapshot, &foundSeq, &bytesRead);
 
-            SSTable cached = tableRef;
-
-            if (tableCache.get(tableRef.getFilePath(), cached)) {
-                res = cached.get(key, val);
-            } else {
-                tableCache.put(tableRef.getFilePath(), tableRef);
-                res = tableRef.get(key, val);
-            }
+            stats.recordTick(Ticker::SSTABLES_READ);
+            stats.recordLevel(level, LevelCounter::GET_TABLES_READ);
+            if (bytesRead)
+                stats.recordLevel(level, LevelCounter::GET_BYTES_READ, bytesRead);
 
             // DELETE dominates
-            if (res == GetResult::DELETED) {
+            if (res == GetResult::DELETED ||
+                (res == GetResult::FOUND && foundSeq < rangeDelSeq)) {
+                value.reset();
                 return false;
             }
 
             if (res == GetResult::FOUND) {
-                blockCache.put(blockKey, val);
-                value = val;
-                cache.put(key, value);
+                if (latest) cache.putIfUnchanged(key, value, seqAtStart, lastSequence);
                 return true;
             }
         }
@@ -318,105 +639,953 @@ bool KVStore::get(const std::string& key, std::string& value) {
 // =======================
 void KVStore::deleteKey(const std::string& key) {
 
-    wal.logDelete(key);
-    memTable->put(key, MemTable::TOMBSTONE);
+    // Before writeMutex: the store asked to flush may be this one
+    writeBufferManager.maybeFlush();
+    maybeRebalanceMemory(key.size());
+    writeController.delayWrite(key.size(), stats);
+
+    stats.recordTick(Ticker::DELETES);
+
+    std::lock_guard<std::mutex> lock(writeMutex);
+
+    const SequenceNumber seq = lastSequence.load() + 1;
+
+    if (!bulkLoading)
+        wal.logDelete(key, seq);
+    memTable->remove(key, seq);
+    lastSequence.store(seq);
 
     cache.remove(key);
 
     if (memTable->isFull())
-        flushMemTable();
+        sealMemTable();
 }
 
 // =======================
-void KVStore::flushMemTable() {
+void KVStore::deleteRange(const std::string& start, const std::string& end) {
+
+    if (!(start < end))
+        return;
+
+    // Before writeMutex: the store asked to flush may be this one
+    writeBufferManager.maybeFlush();
+    maybeRebalanceMemory(start.size() + end.size());
+    writeController.delayWrite(start.size() + end.size(), stats);
+
+    stats.recordTick(Ticker::RANGE_DELETES);
+
+    SequenceNumber seq;
+    {
+        std::lock_guard<std::mutex> lock(writeMutex);
+
+        seq = lastSequence.load() + 1;
+
+        if (!bulkLoading)
+            wal.logDeleteRange(start, end, seq);
+        memTable->addRangeTombstone(start, end, seq);
+        lastSequence.store(seq);
+
+        cache.removeRange(start, end);
+
+        if (memTable->isFull())
+            sealMemTable();
+    }
+
+    dropFilesInRange(start, end, seq);
+}
+
+void KVStore::dropFilesInRange(const std::string& start,
+                               const std::string& end,
+                               SequenceNumber seq) {
+
+    const std::vector<SequenceNumber> live = liveSnapshots();
+
+    std::unique_lock<std::shared_mutex> lock(levelsMutex);
+
+    VersionEdit edit;
+    std::vector<std::string> dropped;
+
+    for (size_t levelIndex = 0; levelIndex < levels.size(); ++levelIndex) {
+        auto& level = levels[levelIndex];
+
+        for (auto it = level.begin(); it != level.end(); ) {
+
+            const SSTableProperties& props = it->getProperties();
+
+            // A snapshot that predates the tombstone may still read it
+            bool visible = !live.empty() && live.back() >= props.smallestSeq;
+
+            // Files being compacted are left to the compaction, whose
+            // output the tombstone still covers
+            if (!visible && props.largestSeq < seq &&
+                !compaction.isCompacting(it->getFilePath()) &&
+                it->getMinKey() >= start && it->getMaxKey() < end) {
+
+                LOG_INFO("Range delete dropped SSTable: " + it->getFilePath());
+                edit.removeFile(static_cast<int>(levelIndex), it->getFilePath());
+                dropped.push_back(it->getFilePath());
+                it = level.erase(it);
+            } else {
+                ++it;
+            }
+        }
+    }
+
+    if (edit.empty())
+        return;
+
+    manifest.logAndApply(edit);
+
+    for (const std::string& path : dropped)
+        std::remove(path.c_str());
+}
+
+// =======================
+const Snapshot* KVStore::getSnapshot() {
+    std::lock_guard<std::mutex> lock(snapshotMutex);
+
+    const SequenceNumber seq = lastSequence.load();
+    snapshots.insert(seq);
+    return new Snapshot(seq);
+}
+
+void KVStore::releaseSnapshot(const Snapshot* snapshot) {
+    if (!snapshot) return;
+
+    {
+        std::lock_guard<std::mutex> lock(snapshotMutex);
+
+        auto it = snapshots.find(snapshot->getSequenceNumber());
+        if (it != snapshots.end())
+            snapshots.erase(it);
+    }
 
-    std::lock_guard<std::mutex> guard(flushMutex);
+    delete snapshot;
+}
 
-    if (memTable->isEmpty()) return;
+std::vector<SequenceNumber> KVStore::liveSnapshots() const {
+    std::lock_guard<std::mutex> lock(snapshotMutex);
+    return std::vector<SequenceNumber>(snapshots.begin(), snapshots.end());
+}
 
-    std::string filePath =
+// =======================
+void KVStore::sealMemTable() {
+
+    if (memTable->isEmpty())
+        return;
+
+    auto imm = std::make_shared<ImmutableMemTable>();
+    imm->mem = memTable;
+    imm->fileNumber = static_cast<uint64_t>(sstableCounter++);
+    imm->filePath =
         configManager.getSSTableDirectory() +
-        "/sstable_" + std::to_string(sstableCounter++) + ".dat";
+        "/sstable_" + std::to_string(imm->fileNumber) + ".dat";
+
+    // Everything logged so far belongs to this MemTable
+    imm->logs = std::move(recoveredLogs);
+    recoveredLogs.clear();
+
+    const std::string sealedLog = wal.rotate();
+    if (!sealedLog.empty())
+        imm->logs.push_back(sealedLog);
+
+    {
+        std::lock_guard<std::mutex> lock(memTableMutex);
+        memTable->markImmutable();
+        imm->id = nextImmutableId++;
+        immutables.push_back(imm);
+        memTable = newMemTable();
+    }
+
+    flushPool->schedule([this] { flushMemTable(); });
+    updateWriteController();
+}
+
+void KVStore::flushMemTable() {
+
+    std::shared_ptr<ImmutableMemTable> imm;
+    {
+        std::lock_guard<std::mutex> lock(memTableMutex);
+
+        for (auto& candidate : immutables) {
+            if (!candidate->claimed) {
+                candidate->claimed = true;
+                imm = candidate;
+                break;
+            }
+        }
+    }
+
+    if (!imm) return;
+
+    StopWatch timer(stats, HistogramType::FLUSH_LATENCY);
 
     SSTable sstable(
-        filePath,
+        imm->filePath,
         configManager.getBloomFilterBitSize(),
         configManager.getBloomFilterHashCount()
     );
 
-    sstable.writeToDisk(memTable->getData());
+    sstable.setRateLimiter(&rateLimiter, IOPriority::HIGH);
+
+    // Bulk-loaded MemTables are ordered only now, in parallel
+    std::unique_ptr<Iterator> it;
+
+    if (imm->mem->isAppendOnly()) {
+        imm->mem->sortEntries(std::max(1, configManager.getBulkLoadSortThreads()));
+        it = std::make_unique<MemTableVectorIterator>(imm->mem->getSortedEntries());
+    } else {
+        it = std::make_unique<MemTableIterator>(imm->mem->getData());
+    }
+
+    FragmentedRangeTombstoneList rangeDels(imm->mem->getRangeTombstones());
+
+    // Versions no snapshot can see are not written out; tombstones are
+    // kept because older SSTables may still hold the key
+    CompactionIterator live(*it, liveSnapshots(), false, &rangeDels);
+
+    FragmentedRangeTombstoneList outDels = live.outputRangeTombstones();
+    sstable.writeToDisk(live, &outDels);
 
     SSTable reloaded(
-        filePath,
+        imm->filePath,
         configManager.getBloomFilterBitSize(),
         configManager.getBloomFilterHashCount()
     );
 
     reloaded.setStatsHook(this);
-    levels[0].push_back(reloaded);
+    reloaded.setBlockCache(&blockCache);
+
+    // Flushes may finish out of order; L0 must stay oldest first.
+    // Readers saw the data in the immutable MemTable until now;
+    // iterators still holding it keep it alive
+    {
+        std::unique_lock<std::mutex> lock(memTableMutex);
+        flushInstalled.wait(lock, [&] { return immutables.front() == imm; });
+
+        {
+            std::unique_lock<std::shared_mutex> levelsLock(levelsMutex);
+
+            // Durable in the manifest before its WAL files go away
+            VersionEdit edit;
+            edit.addFile(0, metaOf(reloaded));
+            edit.setNextFileNumber(imm->fileNumber + 1);
+            edit.setLastSequence(reloaded.getProperties().largestSeq);
+            manifest.logAndApply(edit);
+
+            levels[0].push_back(reloaded);
+        }
+
+        immutables.pop_front();
+    }
 
-    memTable->clear();
-    wal.clear();
+    flushInstalled.notify_all();
 
-    stats.totalFlushes++;
+    for (const std::string& log : imm->logs)
+        std::remove(log.c_str());
+
+    stats.recordTick(Ticker::FLUSHES);
+    stats.recordTick(Ticker::FLUSH_BYTES, reloaded.getFileSize());
+    stats.recordLevel(0, LevelCounter::FLUSH_BYTES, reloaded.getFileSize());
+    stats.measure(HistogramType::FLUSH_BYTES, reloaded.getFileSize());
+
+    rebalanceMemory();
+    updateWriteController();
+    maybeScheduleCompaction();
 }
 
 // =======================
 void KVStore::flush() {
-    if (!memTable->isEmpty())
-        flushMemTable();
+
+    uint64_t target;
+    {
+        std::lock_guard<std::mutex> lock(writeMutex);
+        sealMemTable();
+
+        std::lock_guard<std::mutex> memLock(memTableMutex);
+        target = nextImmutableId;
+    }
+
+    std::unique_lock<std::mutex> lock(memTableMutex);
+    flushInstalled.wait(lock, [&] {
+        return !running || immutables.empty() || immutables.front()->id >= target;
+    });
+}
+
+// =======================
+bool KVStore::validateIngestedFile(const std::string& path, SSTable& table) const {
+
+    if (!std::filesystem::exists(path)) {
+        LOG_ERROR("Ingest: file not found: " + path);
+        return false;
+    }
+
+    table = SSTable(path,
+                    configManager.getBloomFilterBitSize(),
+                    configManager.getBloomFilterHashCount());
+
+    if (!table.hasSequenceNumbers() || table.isEmpty()) {
+        LOG_ERROR("Ingest: not a readable v2 SSTable: " + path);
+        return false;
+    }
+
+    // Range tombstones keep their own sequences, which the file's
+    // ingestion sequence would not cover
+    if (table.getRangeTombstones()) {
+        LOG_ERROR("Ingest: range tombstones are not supported: " + path);
+        return false;
+    }
+
+    SSTableIterator it(table);
+
+    std::string prev;
+    uint64_t count = 0;
+
+    for (; it.valid(); it.next()) {
+        const Slice key = it.key();
+
+        if (count > 0 && !(Slice(prev) < key)) {
+            LOG_ERROR("Ingest: keys out of order in " + path);
+            return false;
+        }
+
+        if (count == 0 && key != Slice(table.getMinKey())) {
+            LOG_ERROR("Ingest: first key does not match the key range: " + path);
+            return false;
+        }
+
+        prev.assign(key.data(), key.size());
+        ++count;
+    }
+
+    if (count != table.getProperties().numEntries || prev != table.getMaxKey()) {
+        LOG_ERROR("Ingest: truncated or inconsistent file: " + path);
+        return false;
+    }
+
+    return true;
+}
+
+bool KVStore::ingestFiles(const std::vector<std::string>& paths) {
+
+    std::vector<SSTable> tables;
+
+    for (const std::string& path : paths) {
+        SSTable table("", 0, 0);
+        if (!validateIngestedFile(path, table))
+            return false;
+        tables.push_back(table);
+    }
+
+    if (tables.empty())
+        return true;
+
+    std::sort(tables.begin(), tables.end(), [](const SSTable& a, const SSTable& b) {
+        return a.getMinKey() < b.getMinKey();
+    });
+
+    for (size_t i = 1; i < tables.size(); ++i) {
+        if (!(tables[i - 1].getMaxKey() < tables[i].getMinKey())) {
+            LOG_ERROR("Ingest: files overlap: " + tables[i - 1].getFilePath() +
+                      ", " + tables[i].getFilePath());
+            return false;
+        }
+    }
+
+    std::lock_guard<std::mutex> writeLock(writeMutex);
+
+    // Reads check MemTables before SSTables, so nothing older than the
+    // ingested entries may stay in one
+    sealMemTable();
+    {
+        std::unique_lock<std::mutex> lock(memTableMutex);
+        const uint64_t target = nextImmutableId;
+
+        flushInstalled.wait(lock, [&] {
+            return !running || immutables.empty() || immutables.front()->id >= target;
+        });
+
+        if (!running)
+            return false;
+    }
+
+    // Move the files in under fresh names, undoing it on failure
+    std::vector<std::pair<std::string, std::string>> moved;   // (from, to)
+
+    for (const SSTable& table : tables) {
+
+        const std::string dest =
+            configManager.getSSTableDirectory() +
+            "/sstable_" + std::to_string(sstableCounter++) + ".dat";
+
+        std::error_code ec;
+        std::filesystem::rename(table.getFilePath(), dest, ec);
+
+        // Across file systems: copy, then drop the source
+        if (ec) {
+            ec.clear();
+            std::filesystem::copy_file(table.getFilePath(), dest, ec);
+            if (!ec)
+                std::filesystem::remove(table.getFilePath(), ec);
+        }
+
+        if (ec) {
+            LOG_ERROR("Ingest: cannot move " + table.getFilePath() + ": " + ec.message());
+
+            for (auto it = moved.rbegin(); it != moved.rend(); ++it)
+                std::filesystem::rename(it->second, it->first, ec);
+            return false;
+        }
+
+        moved.emplace_back(table.getFilePath(), dest);
+    }
+
+    const SequenceNumber seq = lastSequence.load() + 1;
+
+    uint64_t bytes = 0;
+    {
+        std::unique_lock<std::shared_mutex> lock(levelsMutex);
+
+        VersionEdit edit;
+        std::vector<std::pair<size_t, SSTable>> placed;
+
+        for (size_t i = 0; i < tables.size(); ++i) {
+
+            SSTable table(moved[i].second,
+                          configManager.getBloomFilterBitSize(),
+                          configManager.getBloomFilterHashCount());
+
+            table.setGlobalSequence(seq);
+            table.setStatsHook(this);
+            table.setBlockCache(&blockCache);
+
+            // Deepest level before the first one holding an overlap
+            // (L0 if L0 overlaps: appended there, it is the newest)
+            size_t level = 0;
+            for (size_t l = 0; l < levels.size(); ++l) {
+                bool overlaps = false;
+                for (const SSTable& t : levels[l])
+                    if (!(t.getMaxKey() < table.getMinKey() || table.getMaxKey() < t.getMinKey()))
+                        overlaps = true;
+
+                if (overlaps)
+                    break;
+                level = l;
+            }
+
+            edit.addFile(static_cast<int>(level), metaOf(table));
+            bytes += table.getFileSize();
+            placed.emplace_back(level, std::move(table));
+
+            LOG_INFO("Ingested " + moved[i].first + " into L" + std::to_string(level));
+        }
+
+        edit.setNextFileNumber(static_cast<uint64_t>(sstableCounter));
+        edit.setLastSequence(seq);
+        manifest.logAndApply(edit);
+
+        for (auto& p : placed) {
+            auto& level = levels[p.first];
+            level.push_back(std::move(p.second));
+
+            if (p.first > 0)
+                std::sort(level.begin(), level.end(), [](const SSTable& a, const SSTable& b) {
+                    return a.getMinKey() < b.getMinKey();
+                });
+        }
+
+        lastSequence.store(seq);
+    }
+
+    for (const SSTable& table : tables) {
+        cache.removeRange(table.getMinKey(), table.getMaxKey());
+        cache.remove(table.getMaxKey());
+    }
+
+    stats.recordTick(Ticker::INGESTED_FILES, tables.size());
+    stats.recordTick(Ticker::INGESTED_BYTES, bytes);
+
+    updateWriteController();
+    maybeScheduleCompaction();
+
+    return true;
 }
 
 // =======================
-void KVStore::backgroundFlush() {
-    while (running) {
-        std::this_thread::sleep_for(std::chrono::seconds(5));
-        flushMemTable();
+void KVStore::finishBulkLoad() {
+
+    {
+        std::lock_guard<std::mutex> lock(writeMutex);
+
+        if (!bulkLoading)
+            return;
+
+        bulkLoading = false;
+        sealMemTable();
+
+        std::lock_guard<std::mutex> memLock(memTableMutex);
+        if (memTable->isAppendOnly())
+            memTable = newMemTable();
     }
+
+    flush();
+
+    // One pass over everything the load put in L0, instead of pushing
+    // it down level by level
+    std::shared_ptr<CompactionJob> job;
+    {
+        std::unique_lock<std::shared_mutex> lock(levelsMutex);
+        compactionDeferred = false;
+        job = compaction.pickL0(levels);
+    }
+
+    LOG_INFO("Bulk load finished; final compaction of " +
+             std::to_string(job ? job->upper.size() : 0) + " L0 files");
+
+    if (job)
+        backgroundCompaction(*job);
+    else
+        maybeScheduleCompaction();
+
+    updateWriteController();
+}
+
+void KVStore::maybeScheduleCompaction() {
+
+    if (!running || compactionDeferred)
+        return;
+
+    std::unique_lock<std::shared_mutex> lock(levelsMutex);
+
+    while (compaction.runningCount() < maxCompactions) {
+
+        std::shared_ptr<CompactionJob> job = compaction.pick(levels, levelScores());
+        if (!job)
+            break;
+
+        compactionPool->schedule([this, job] { backgroundCompaction(*job); },
+                                 job->score);
+    }
+}
+
+void KVStore::backgroundCompaction(CompactionJob& job) {
+
+    compaction.execute(job, liveSnapshots());
+
+    for (SSTable& table : job.outputs) {
+        table.setStatsHook(this);
+        table.setBlockCache(&blockCache);
+    }
+
+    {
+        std::unique_lock<std::shared_mutex> lock(levelsMutex);
+
+        // Logged before install() deletes the inputs
+        VersionEdit edit;
+        for (const SSTable& t : job.upper)
+            edit.removeFile(static_cast<int>(job.level), t.getFilePath());
+        for (const SSTable& t : job.lower)
+            edit.removeFile(static_cast<int>(job.outputLevel), t.getFilePath());
+        for (const SSTable& t : job.outputs)
+            edit.addFile(static_cast<int>(job.outputLevel), metaOf(t));
+        manifest.logAndApply(edit);
+
+        compaction.install(levels, job);
+    }
+
+    rebalanceMemory();
+    updateWriteController();
+    maybeScheduleCompaction();
+}
+
+std::vector<double> KVStore::levelScores() const {
+
+    std::vector<double> scores(levels.size(), 0.0);
+
+    const int threshold = std::max(1, configManager.getL0Threshold());
+    scores[0] = static_cast<double>(levels[0].size()) / threshold;
+
+    for (size_t level = 1; level < levels.size(); level++) {
+        uint64_t bytes = 0;
+        for (const auto& table : levels[level])
+            bytes += table.getFileSize();
+
+        const uint64_t target = manifest.levelMaxBytes(static_cast<int>(level));
+
+        // Above the dynamic base level: whatever is here moves down
+        if (target == 0)
+            scores[level] = bytes ? 1.0 + static_cast<double>(bytes) /
+                                        std::max<uint64_t>(1, configManager.getLevelBaseBytes())
+                                  : 0.0;
+        else
+            scores[level] = static_cast<double>(bytes) / target;
+    }
+
+    return scores;
+}
+
+uint64_t KVStore::estimatePendingCompactionBytes() const {
+
+    const size_t threshold = std::max(1, configManager.getL0Threshold());
+
+    uint64_t pending = 0;
+
+    if (levels[0].size() >= threshold)
+        for (const auto& table : levels[0])
+            pending += table.getFileSize();
+
+    // The last level has nowhere to compact into
+    for (size_t level = 1; level + 1 < levels.size(); level++) {
+        uint64_t bytes = 0;
+        for (const auto& table : levels[level])
+            bytes += table.getFileSize();
+
+        const uint64_t target = manifest.levelMaxBytes(static_cast<int>(level));
+        if (bytes > target)
+            pending += bytes - target;
+    }
+
+    return pending;
+}
+
+void KVStore::updateWriteController() {
+
+    int l0Files;
+    uint64_t pending;
+    {
+        std::shared_lock<std::shared_mutex> lock(levelsMutex);
+        l0Files = static_cast<int>(levels[0].size());
+        pending = estimatePendingCompactionBytes();
+    }
+
+    int immutableCount;
+    {
+        std::lock_guard<std::mutex> lock(memTableMutex);
+        immutableCount = static_cast<int>(immutables.size());
+    }
+
+    // Deferred compaction is not debt until the load is over
+    if (compactionDeferred) {
+        l0Files = 0;
+        pending = 0;
+    }
+
+    writeController.update(l0Files, immutableCount, pending);
+
+    if (rateLimiter.tuneDue())
+        tuneRateLimiter(l0Files, pending);
+}
+
+void KVStore::tuneRateLimiter(int l0Files, uint64_t pendingCompactionBytes) {
+
+    std::unique_lock<std::mutex> lock(tuneMutex, std::try_to_lock);
+    if (!lock.owns_lock())
+        return;
+
+    const WriteControllerOptions& wc = configManager.getWriteControllerOptions();
+
+    const double debt = std::max(
+        static_cast<double>(l0Files) / std::max(1, wc.l0SlowdownTrigger),
+        static_cast<double>(pendingCompactionBytes) /
+            std::max<uint64_t>(1, wc.pendingCompactionSlowdownBytes));
+
+    const HistogramSnapshot now = stats.getHistogram(HistogramType::GET_LATENCY);
+    const HistogramSnapshot recent = now.since(lastGetLatency);
+    lastGetLatency = now;
+
+    rateLimiter.tune(debt, recent.count ? recent.percentile(99) : 0);
 }
 
 // =======================
 void KVStore::scan(const std::string& start,
                    const std::string& end) {
 
-    std::map<std::string, std::string> result;
+    std::unique_ptr<Iterator> it =
+        newIterator(lastSequence.load(), start, end);
+
+    const Slice last(end);
 
-    for (const auto& kv : memTable->getData()) {
-        if (kv.first >= start && kv.first <= end)
-            result[kv.first] = kv.second;
+    for (it->seek(start); it->valid(); it->next()) {
+
+        Slice k = it->key();
+        if (k > last)
+            break;
+
+        Slice v = it->value();
+
+        std::cout.write(k.data(), k.size());
+        std::cout << " -> ";
+        std::cout.write(v.data(), v.size());
+        std::cout << "\n";
     }
+}
 
-    for (char c = start[0]; c <= end[0]; c++) {
+// =======================
+std::unique_ptr<Iterator> KVStore::newIterator(const ReadOptions& options) {
 
-        std::string key(1, c);
-        std::string value;
+    const SequenceNumber snapshot = options.snapshot
+        ? options.snapshot->getSequenceNumber()
+        : lastSequence.load();
 
-        for (auto& level : levels) {
-            for (auto& table : level) {
+    return newIterator(snapshot, "", "");
+}
 
-                if (key < table.getMinKey() || key > table.getMaxKey())
-                    continue;
+std::unique_ptr<Iterator> KVStore::newIterator(SequenceNumber snapshot,
+                                               const std::string& start,
+                                               const std::string& end) {
 
-                if (!table.mightContain(key)) continue;
+    // Newest source first: MemTables, then L0 newest -> oldest, then L1..
+    const std::vector<std::shared_ptr<MemTable>> memSources = memTables();
 
-                GetResult res = table.get(key, value);
+    std::vector<std::shared_ptr<const SkipList>> mems;
+    std::vector<std::unique_ptr<Iterator>> sources;
+    std::vector<RangeTombstone> tombstones;
 
-                if (res == GetResult::FOUND)
-                    result[key] = value;
+    for (size_t i = 0; i < memSources.size(); i++) {
 
-                if (res == GetResult::DELETED)
-                    result.erase(key);
-            }
+        // Read in place, the active one included, and kept alive by the
+        // iterator. Append-only ones have no order yet: only the part in
+        // [start, end] is copied into one
+        std::shared_ptr<const SkipList> mem = memSources[i]->isAppendOnly()
+            ? memSources[i]->snapshotData(start, end)
+            : std::shared_ptr<const SkipList>(memSources[i], &memSources[i]->getData());
+
+        sources.push_back(std::make_unique<MemTableIterator>(*mem));
+        mems.push_back(std::move(mem));
+
+        for (const RangeTombstone& t : memSources[i]->getRangeTombstones())
+            tombstones.push_back(t);
+    }
+
+    std::shared_lock<std::shared_mutex> lock(levelsMutex);
+
+    for (size_t level = 0; level < levels.size(); level++) {
+
+        const size_t count = levels[level].size();
+
+        for (size_t i = 0; i < count; i++) {
+
+            const SSTable& table =
+                levels[level][level == 0 ? count - 1 - i : i];
+
+            if (table.getMaxKey() < start ||
+                (!end.empty() && table.getMinKey() > end))
+                continue;
+
+            sources.push_back(std::make_unique<SSTableIterator>(table));
+
+            if (auto dels = table.getRangeTombstones())
+                dels->appendTo(tombstones);
         }
     }
 
-    for (const auto& kv : result) {
+    return std::make_unique<DBIterator>(
+        std::move(mems), std::move(sources), tombstones, snapshot);
+}
 
-        if (kv.second == MemTable::TOMBSTONE)
-            continue;
+// =======================
+double KVStore::writeAmplification() const {
+
+    const uint64_t user = stats.getTickerCount(Ticker::BYTES_WRITTEN);
+    if (user == 0)
+        return 0.0;
+
+    return static_cast<double>(stats.getTickerCount(Ticker::FLUSH_BYTES) +
+                               stats.getTickerCount(Ticker::COMPACTION_BYTES_WRITTEN)) /
+           user;
+}
+
+double KVStore::readAmplification() const {
+
+    const uint64_t gets = stats.getTickerCount(Ticker::GETS);
+    if (gets == 0)
+        return 0.0;
+
+    return static_cast<double>(stats.getTickerCount(Ticker::SSTABLES_READ)) / gets;
+}
+
+double KVStore::spaceAmplification() const {
+
+    std::shared_lock<std::shared_mutex> lock(levelsMutex);
+
+    uint64_t total = 0, largest = 0;
+
+    for (const auto& level : levels) {
+        uint64_t bytes = 0;
+        for (const auto& table : level)
+            bytes += table.getFileSize();
+
+        total += bytes;
+        largest = std::max(largest, bytes);
+    }
+
+    return largest ? static_cast<double>(total) / largest : 0.0;
+}
+
+// =======================
+MemoryUsage KVStore::getApproximateMemoryUsage() const {
+
+    MemoryUsage usage;
+    usage.budget = configManager.getMemoryBudgetBytes();
+
+    for (const std::shared_ptr<MemTable>& mem : memTables())
+        usage.memTables += mem->getMemoryUsage();
+
+    usage.rowCache = cache.getUsage();
+    usage.blockCache = blockCache.getUsage();
+    usage.tableCache = tableCache.getUsage();
+
+    std::shared_lock<std::shared_mutex> lock(levelsMutex);
+
+    for (const auto& level : levels)
+        for (const SSTable& table : level)
+            usage.tableReaders += table.approximateMemoryUsage();
+
+    return usage;
+}
+
+void KVStore::rebalanceMemory() {
+
+    const size_t budget = configManager.getMemoryBudgetBytes();
+    if (budget == 0)
+        return;
+
+    const MemoryUsage usage = getApproximateMemoryUsage();
+
+    // Only the caches can give memory back on demand; MemTables are
+    // held to their share by the write buffer manager
+    const size_t fixed = usage.memTables + usage.tableReaders + usage.tableCache;
+    const size_t forCaches = budget > fixed ? budget - fixed : 0;
+
+    const size_t rowBytes =
+        static_cast<size_t>(static_cast<double>(forCaches) * configManager.getRowCacheRatio());
+
+    cache.setCapacityBytes(rowBytes);
+    blockCache.setCapacityBytes(forCaches - rowBytes);
 
-        std::cout << kv.first << " -> " << kv.second << "\n";
+    if (fixed > budget)
+        LOG_DEBUG("Memory budget exceeded without caches: " + std::to_string(fixed) +
+                  " of " + std::to_string(budget) + " bytes");
+}
+
+void KVStore::maybeRebalanceMemory(size_t bytesWritten) {
+
+    const size_t budget = configManager.getMemoryBudgetBytes();
+    if (budget == 0)
+        return;
+
+    const size_t step = std::max<size_t>(1, budget / 64);
+
+    if (bytesSinceRebalance.fetch_add(bytesWritten) + bytesWritten < step)
+        return;
+
+    // One writer does it
+    if (bytesSinceRebalance.exchange(0) < step)
+        return;
+
+    rebalanceMemory();
+}
+
+std::vector<LevelStats> KVStore::getLevelStats() const {
+
+    std::vector<LevelStats> rows;
+
+    {
+        std::shared_lock<std::shared_mutex> lock(levelsMutex);
+
+        for (size_t level = 0; level < levels.size(); level++) {
+            LevelStats row;
+            row.level = level;
+            row.files = levels[level].size();
+            for (const auto& table : levels[level])
+                row.liveBytes += table.getFileSize();
+            rows.push_back(row);
+        }
     }
+
+    for (LevelStats& row : rows) {
+        const size_t l = row.level;
+
+        row.flushBytes = stats.getLevelCount(l, LevelCounter::FLUSH_BYTES);
+        row.compactionReadUpper = stats.getLevelCount(l, LevelCounter::COMPACTION_READ_UPPER);
+        row.compactionReadLower = stats.getLevelCount(l, LevelCounter::COMPACTION_READ_LOWER);
+        row.compactionWritten = stats.getLevelCount(l, LevelCounter::COMPACTION_WRITTEN);
+        row.movedBytes = stats.getLevelCount(l, LevelCounter::TRIVIAL_MOVE_BYTES);
+        row.compactions = stats.getLevelCount(l, LevelCounter::COMPACTIONS);
+        row.compactionSeconds = stats.getLevelCount(l, LevelCounter::COMPACTION_NANOS) / 1e9;
+        row.getTablesRead = stats.getLevelCount(l, LevelCounter::GET_TABLES_READ);
+        row.getBytesRead = stats.getLevelCount(l, LevelCounter::GET_BYTES_READ);
+
+        const uint64_t in = l == 0 ? stats.getTickerCount(Ticker::BYTES_WRITTEN)
+                                   : row.compactionReadUpper;
+        const uint64_t out = row.flushBytes + row.compactionWritten;
+
+        row.writeAmp = in ? static_cast<double>(out) / in : 0.0;
+    }
+
+    return rows;
+}
+
+std::string KVStore::getLevelStatsTable() const {
+
+    const std::vector<LevelStats> rows = getLevelStats();
+
+    auto mb = [](uint64_t bytes) { return bytes / 1048576.0; };
+
+    char line[256];
+    std::string out;
+
+    std::snprintf(line, sizeof(line),
+                  "%-5s %6s %9s %9s %9s %9s %9s %9s %6s %6s %8s %9s %9s\n",
+                  "Level", "Files", "Size(MB)", "Flush(MB)", "Rn(MB)", "Rnp1(MB)",
+                  "Write(MB)", "Moved(MB)", "W-Amp", "Comp", "Comp(s)", "GetTables", "GetRd(MB)");
+    out += line;
+    out += std::string(114, '-') + "\n";
+
+    LevelStats sum;
+    uint64_t written = 0;
+
+    for (const LevelStats& r : rows) {
+        std::snprintf(line, sizeof(line),
+                      "L%-4zu %6zu %9.2f %9.2f %9.2f %9.2f %9.2f %9.2f %6.2f %6llu %8.2f %9llu %9.2f\n",
+                      r.level, r.files, mb(r.liveBytes), mb(r.flushBytes),
+                      mb(r.compactionReadUpper), mb(r.compactionReadLower),
+                      mb(r.compactionWritten), mb(r.movedBytes), r.writeAmp,
+                      static_cast<unsigned long long>(r.compactions), r.compactionSeconds,
+                      static_cast<unsigned long long>(r.getTablesRead), mb(r.getBytesRead));
+        out += line;
+
+        sum.files += r.files;
+        sum.liveBytes += r.liveBytes;
+        sum.flushBytes += r.flushBytes;
+        sum.compactionReadUpper += r.compactionReadUpper;
+        sum.compactionReadLower += r.compactionReadLower;
+        sum.compactionWritten += r.compactionWritten;
+        sum.movedBytes += r.movedBytes;
+        sum.compactions += r.compactions;
+        sum.compactionSeconds += r.compactionSeconds;
+        sum.getTablesRead += r.getTablesRead;
+        sum.getBytesRead += r.getBytesRead;
+        written += r.flushBytes + r.compactionWritten;
+    }
+
+    std::snprintf(line, sizeof(line),
+                  "%-5s %6zu %9.2f %9.2f %9.2f %9.2f %9.2f %9.2f %6.2f %6llu %8.2f %9llu %9.2f\n",
+                  "Sum", sum.files, mb(sum.liveBytes), mb(sum.flushBytes),
+                  mb(sum.compactionReadUpper), mb(sum.compactionReadLower),
+                  mb(sum.compactionWritten), mb(sum.movedBytes), writeAmplification(),
+                  static_cast<unsigned long long>(sum.compactions), sum.compactionSeconds,
+                  static_cast<unsigned long long>(sum.getTablesRead), mb(sum.getBytesRead));
+    out += line;
+
+    std::snprintf(line, sizeof(line),
+                  "User writes %.2f MB, SSTable writes %.2f MB | "
+                  "W-Amp %.2f  R-Amp %.2f tables/get  S-Amp %.2f\n",
+                  mb(stats.getTickerCount(Ticker::BYTES_WRITTEN)), mb(written),
+                  writeAmplification(), readAmplification(), spaceAmplification());
+    out += line;
+
+    return out;
 }
 
 // =======================
@@ -431,18 +1600,113 @@ void KVStore::printStats() const {
 
     if (seconds < 1) seconds = 1;
 
+    const uint64_t hits = stats.getTickerCount(Ticker::CACHE_HITS);
+    const uint64_t misses = stats.getTickerCount(Ticker::CACHE_MISSES);
+
     std::cout << "PUT Throughput : "
-              << stats.totalPuts / seconds << "\n";
+              << stats.getTickerCount(Ticker::PUTS) / seconds << "\n";
 
     std::cout << "GET Throughput : "
-              << stats.totalGets / seconds << "\n";
+              << stats.getTickerCount(Ticker::GETS) / seconds << "\n";
 
     std::cout << "Cache Hit Rate : "
-              << (double)stats.cacheHits /
-                 (stats.cacheHits + stats.cacheMisses + 1)
+              << (double)hits / (hits + misses + 1)
               << "\n";
 
-    std::cout << "Bloom Checks : " << stats.bloomChecks << "\n";
-    std::cout << "Bloom Negatives : " << stats.bloomNegatives << "\n";
-    std::cout << "Bloom False Positives : " << stats.bloomFalsePositives << "\n";
+    std::cout << "Bloom Checks : " << stats.getTickerCount(Ticker::BLOOM_CHECKS) << "\n";
+    std::cout << "Bloom Negatives : " << stats.getTickerCount(Ticker::BLOOM_NEGATIVES) << "\n";
+    std::cout << "Bloom False Positives : " << stats.getTickerCount(Ticker::BLOOM_FALSE_POSITIVES) << "\n";
+
+    for (HistogramType type : {HistogramType::GET_LATENCY,
+                               HistogramType::PUT_LATENCY,
+                               HistogramType::FLUSH_LATENCY}) {
+        const HistogramSnapshot h = stats.getHistogram(type);
+        std::cout << Statistics::histogramName(type)
+                  << " : p50 " << h.percentile(50)
+                  << " p99 " << h.percentile(99)
+                  << " p99.9 " << h.percentile(99.9)
+                  << " max " << h.max << "\n";
+    }
+
+    const MemoryUsage memory = getApproximateMemoryUsage();
+
+    std::cout << "Memory (MB) : memtables " << memory.memTables / 1048576.0
+              << ", row cache " << memory.rowCache / 1048576.0
+              << ", block cache " << memory.blockCache / 1048576.0
+              << ", table cache " << memory.tableCache / 1048576.0
+              << ", table readers " << memory.tableReaders / 1048576.0
+              << ", total " << memory.total() / 1048576.0;
+    if (memory.budget)
+        std::cout << " of " << memory.budget / 1048576.0;
+    std::cout << "\n";
+
+    const WriteCondition condition = writeController.getCondition();
+
+    std::cout << "Write Condition : "
+              << (condition == WriteCondition::STOPPED ? "stopped" :
+                  condition == WriteCondition::DELAYED ? "delayed" : "normal");
+    if (condition != WriteCondition::NORMAL)
+        std::cout << " (" << WriteController::causeName(writeController.getCause()) << ")";
+    std::cout << "\n";
+
+    std::cout << "Stalled Writes : " << stats.getTickerCount(Ticker::STALLED_WRITES)
+              << " (slowdown " << stats.getTickerCount(Ticker::STALL_SLOWDOWN_NANOS) / 1e6
+              << " ms, stop " << stats.getTickerCount(Ticker::STALL_STOP_NANOS) / 1e6
+              << " ms)\n";
+
+    std::cout << "Stall Causes : L0 files "
+              << stats.getTickerCount(Ticker::STALL_L0_FILES_NANOS) / 1e6
+              << " ms, memtables "
+              << stats.getTickerCount(Ticker::STALL_MEMTABLES_NANOS) / 1e6
+              << " ms, pending compaction "
+              << stats.getTickerCount(Ticker::STALL_PENDING_COMPACTION_NANOS) / 1e6
+              << " ms\n";
+
+    for (const ThreadPool* pool : {flushPool.get(), compactionPool.get()}) {
+        const ThreadPoolStats p = pool->getStats();
+        std::cout << "Pool " << pool->getName()
+                  << " : threads " << p.threads
+                  << ", queued " << p.queued
+                  << ", active " << p.active
+                  << ", done " << p.completed
+                  << ", utilization " << p.utilization * 100 << "%\n";
+    }
+
+    const RateLimiterStats io = rateLimiter.getStats();
+
+    if (io.bytesPerSecond) {
+        std::cout << "Background I/O Limit : " << io.bytesPerSecond / 1048576.0 << " MB/s"
+                  << " (flush " << io.bytes[0] / 1048576.0 << " MB, waited "
+                  << io.waitNanos[0] / 1e6 << " ms; compaction "
+                  << io.bytes[1] / 1048576.0 << " MB, waited "
+                  << io.waitNanos[1] / 1e6 << " ms)\n";
+    }
+
+    uint64_t pointDeletes = 0, rangeDeletes = 0, deadBytes = 0;
+    {
+        std::shared_lock<std::shared_mutex> lock(levelsMutex);
+
+        for (const auto& level : levels) {
+            for (const auto& table : level) {
+                pointDeletes += table.getProperties().numDeletions;
+                rangeDeletes += table.getProperties().numRangeDeletions;
+                deadBytes += table.estimatedDeadBytes();
+            }
+        }
+    }
+
+    std::cout << "Tombstones : " << pointDeletes << " point, " << rangeDeletes
+              << " range (~" << deadBytes / 1048576.0 << " MB reclaimable; "
+              << stats.getTickerCount(Ticker::TOMBSTONE_COMPACTIONS)
+              << " compactions triggered)\n";
+
+    std::cout << "Trivial Moves : " << stats.getTickerCount(Ticker::TRIVIAL_MOVES)
+              << " (" << stats.getTickerCount(Ticker::TRIVIAL_MOVE_BYTES) / 1048576.0
+              << " MB not rewritten)\n";
+
+    std::cout << "Write Amplification : " << writeAmplification() << "\n";
+    std::cout << "Read Amplification : " << readAmplification() << "\n";
+    std::cout << "Space Amplification : " << spaceAmplification() << "\n";
+
+    std::cout << "\n" << getLevelStatsTable();
 }
\ No newline at end of file
@@ -1,22 +1,72 @@
 #include "LRUCache.h"
+#include "PerfContext.h"
 
 LRUCache::LRUCache(size_t cap){
     capacity = cap;
 }
 
+// List node, hash-map node and bucket, each with an allocator header
+static constexpr size_t NODE_OVERHEAD = 8 * sizeof(void*) + 3 * sizeof(size_t);
+
+size_t LRUCache::charge(const Node& node){
+    // The map holds its own copy of the key
+    return 2 * node.key.capacity() + node.value.pinnedBytes() +
+           sizeof(Node) + NODE_OVERHEAD;
+}
+
+void LRUCache::evictLocked(){
+
+    while (!cacheList.empty() &&
+           (cacheList.size() > capacity || usage > capacityBytes)) {
+
+        usage -= charge(cacheList.back());
+        cacheMap.erase(cacheList.back().key);
+        cacheList.pop_back();
+    }
+}
+
+void LRUCache::setCapacity(size_t entries){
+    std::lock_guard<std::mutex> lock(mtx);
+    capacity = entries;
+    evictLocked();
+}
+
+void LRUCache::setCapacityBytes(size_t bytes){
+    std::lock_guard<std::mutex> lock(mtx);
+    capacityBytes = bytes;
+    evictLocked();
+}
+
 bool LRUCache::get(const std::string& key, std::string& value){
 
+    PinnableSlice pinned;
+
+    if (!get(key, pinned))
+        return false;
+
+    value.assign(pinned.data(), pinned.size());
+
+    return true;
+}
+
+bool LRUCache::get(const std::string& key, PinnableSlice& value){
+
+    std::lock_guard<std::mutex> lock(mtx);
+
     auto it = cacheMap.find(key);
 
     if (it == cacheMap.end()) {
         misses++;
+        PERF_COUNTER_ADD(rowCacheMisses, 1);
         return false;
     }
 
     hits++;
+    PERF_COUNTER_ADD(rowCacheHits, 1);
 
     cacheList.splice(cacheList.begin(), cacheList, it->second);
 
+    // Shares the pin, no byte copy
     value = it->second->value;
 
     return true;
@@ -24,40 +74,86 @@ bool LRUCache::get(const std::string& key, std::string& value){
 
 void LRUCache::put(const std::string& key, const std::string& value){
 
+    PinnableSlice owned;
+    owned.pinSelf(value);
+
+    put(key, owned);
+}
+
+void LRUCache::put(const std::string& key, const PinnableSlice& value){
+
+    std::lock_guard<std::mutex> lock(mtx);
+
+    putLocked(key, value);
+}
+
+bool LRUCache::putIfUnchanged(const std::string& key, const PinnableSlice& value,
+                              uint64_t seqAtLookupStart,
+                              const std::atomic<uint64_t>& lastSequence){
+
+    std::lock_guard<std::mutex> lock(mtx);
+
+    if (lastSequence.load() != seqAtLookupStart)
+        return false;
+
+    putLocked(key, value);
+    return true;
+}
+
+void LRUCache::putLocked(const std::string& key, const PinnableSlice& value){
+
     auto it = cacheMap.find(key);
 
     if (it != cacheMap.end()) {
 
+        usage -= charge(*it->second);
         it->second->value = value;
+        usage += charge(*it->second);
 
         cacheList.splice(cacheList.begin(), cacheList, it->second);
 
+        evictLocked();
         return;
     }
 
-    if(cacheList.size() == capacity){
-
-        auto last = cacheList.back();
-
-        cacheMap.erase(last.key);
-
-        cacheList.pop_back();
-    }
-
     cacheList.push_front({key,value});
 
     cacheMap[key] = cacheList.begin();
+    usage += charge(cacheList.front());
+
+    evictLocked();
 }
 
 
 void LRUCache::remove(const std::string& key)
 {
+    std::lock_guard<std::mutex> lock(mtx);
+
     auto it = cacheMap.find(key);
 
     if (it == cacheMap.end())
         return;
 
+    usage -= charge(*it->second);
+
     cacheList.erase(it->second);
 
     cacheMap.erase(it);
+}
+
+
+void LRUCache::removeRange(const std::string& start, const std::string& end)
+{
+    std::lock_guard<std::mutex> lock(mtx);
+
+    for (auto it = cacheList.begin(); it != cacheList.end(); ) {
+
+        if (it->key >= start && it->key < end) {
+            usage -= charge(*it);
+            cacheMap.erase(it->key);
+            it = cacheList.erase(it);
+        } else {
+            ++it;
+        }
+    }
 }
\ No newline at end of file
@@ -4,30 +4,385 @@
 #include <fstream>
 #include <filesystem>
 #include <sstream>
+#include <algorithm>
+#include <cstring>
+
+namespace {
+
+enum EditTag : uint8_t {
+    ADD_FILE = 1,           // u32 level, path, minKey, maxKey, u64 size
+    REMOVE_FILE = 2,        // u32 level, path
+    NEXT_FILE_NUMBER = 3,   // u64
+    LAST_SEQUENCE = 4,      // u64
+    ADD_INGESTED_FILE = 5   // ADD_FILE fields, u64 global sequence
+};
+
+// A damaged length must not make load() allocate gigabytes
+constexpr uint32_t MAX_RECORD_BYTES = 64u << 20;
+
+// CRC-32 (IEEE 802.3, reflected)
+uint32_t crc32(const char* data, size_t n) {
+
+    static const auto table = [] {
+        std::vector<uint32_t> t(256);
+        for (uint32_t i = 0; i < 256; i++) {
+            uint32_t c = i;
+            for (int k = 0; k < 8; k++)
+                c = (c & 1) ? 0xEDB88320u ^ (c >> 1) : c >> 1;
+            t[i] = c;
+        }
+        return t;
+    }();
+
+    uint32_t crc = 0xFFFFFFFFu;
+    for (size_t i = 0; i < n; i++)
+        crc = table[(crc ^ static_cast<uint8_t>(data[i])) & 0xFF] ^ (crc >> 8);
+
+    return crc ^ 0xFFFFFFFFu;
+}
+
+void putU32(std::string& out, uint32_t v) {
+    out.append(reinterpret_cast<const char*>(&v), sizeof(v));
+}
+
+void putU64(std::string& out, uint64_t v) {
+    out.append(reinterpret_cast<const char*>(&v), sizeof(v));
+}
+
+void putString(std::string& out, const std::string& s) {
+    putU32(out, static_cast<uint32_t>(s.size()));
+    out.append(s);
+}
+
+// Bounds-checked reader over one encoded edit
+struct Reader {
+    const char* p;
+    const char* limit;
+
+    bool u8(uint8_t& v) {
+        if (limit - p < 1) return false;
+        v = static_cast<uint8_t>(*p++);
+        return true;
+    }
+
+    bool u32(uint32_t& v) {
+        if (limit - p < 4) return false;
+        std::memcpy(&v, p, 4);
+        p += 4;
+        return true;
+    }
+
+    bool u64(uint64_t& v) {
+        if (limit - p < 8) return false;
+        std::memcpy(&v, p, 8);
+        p += 8;
+        return true;
+    }
+
+    bool str(std::string& s) {
+        uint32_t n;
+        if (!u32(n) || static_cast<size_t>(limit - p) < n) return false;
+        s.assign(p, n);
+        p += n;
+        return true;
+    }
+};
+
+}
+
+// =======================
+// VERSION EDIT
+// =======================
+void VersionEdit::encodeTo(std::string& out) const {
+
+    for (const auto& r : removed) {
+        out.push_back(static_cast<char>(REMOVE_FILE));
+        putU32(out, static_cast<uint32_t>(r.first));
+        putString(out, r.second);
+    }
+
+    for (const auto& a : added) {
+        const bool ingested = a.second.globalSeq != 0;
+
+        out.push_back(static_cast<char>(ingested ? ADD_INGESTED_FILE : ADD_FILE));
+        putU32(out, static_cast<uint32_t>(a.first));
+        putString(out, a.second.filePath);
+        putString(out, a.second.minKey);
+        putString(out, a.second.maxKey);
+        putU64(out, a.second.fileSize);
+
+        if (ingested)
+            putU64(out, a.second.globalSeq);
+    }
+
+    if (hasNextFileNumber) {
+        out.push_back(static_cast<char>(NEXT_FILE_NUMBER));
+        putU64(out, nextFileNumber);
+    }
+
+    if (hasLastSequence) {
+        out.push_back(static_cast<char>(LAST_SEQUENCE));
+        putU64(out, lastSequence);
+    }
+}
+
+bool VersionEdit::decodeFrom(const char* p, size_t n, VersionEdit& edit) {
+
+    edit = VersionEdit();
+    Reader r{p, p + n};
+
+    uint8_t tag;
+    while (r.u8(tag)) {
+
+        uint32_t level;
+
+        switch (tag) {
+            case ADD_FILE:
+            case ADD_INGESTED_FILE: {
+                SSTableMeta meta;
+                if (!r.u32(level) || !r.str(meta.filePath) || !r.str(meta.minKey) ||
+                    !r.str(meta.maxKey) || !r.u64(meta.fileSize))
+                    return false;
+                if (tag == ADD_INGESTED_FILE && !r.u64(meta.globalSeq))
+                    return false;
+                edit.addFile(static_cast<int>(level), meta);
+                break;
+            }
+            case REMOVE_FILE: {
+                std::string path;
+                if (!r.u32(level) || !r.str(path))
+                    return false;
+                edit.removeFile(static_cast<int>(level), path);
+                break;
+            }
+            case NEXT_FILE_NUMBER: {
+                uint64_t v;
+                if (!r.u64(v)) return false;
+                edit.setNextFileNumber(v);
+                break;
+            }
+            case LAST_SEQUENCE: {
+                uint64_t v;
+                if (!r.u64(v)) return false;
+                edit.setLastSequence(v);
+                break;
+            }
+            default:
+                return false;
+        }
+    }
+
+    return true;
+}
 
-ManifestManager::ManifestManager(const std::string& manifestPath)
-    : manifestPath(manifestPath) {
+// =======================
+// MANIFEST
+// =======================
+ManifestManager::ManifestManager(const std::string& manifestPath,
+                                 const std::string& legacyTextPath)
+    : manifestPath(manifestPath),
+      legacyTextPath(legacyTextPath) {
 
-    levels.resize(4);   // MAX_LEVELS
-    levelBytes.resize(4, 0ULL);
+    levels.resize(numLevels);
+    levelBytes.resize(numLevels, 0ULL);
 
     LOG_INFO("ManifestManager initialized at path: " + manifestPath);
 }
 
+void ManifestManager::apply(const VersionEdit& edit) {
+
+    for (const auto& r : edit.removed) {
+
+        bool found = false;
+
+        for (size_t level = 0; level < levels.size() && !found; ++level) {
+
+            auto& vec = levels[level];
+
+            auto it = std::find_if(vec.begin(), vec.end(), [&](const SSTableMeta& m) {
+                return m.filePath == r.second;
+            });
+
+            if (it != vec.end()) {
+                levelBytes[level] -= it->fileSize;
+                vec.erase(it);
+                found = true;
+            }
+        }
+
+        if (!found)
+            LOG_ERROR("Manifest edit removes unknown SSTable: " + r.second);
+    }
+
+    for (const auto& a : edit.added) {
+
+        if (a.first < 0) {
+            LOG_ERROR("Manifest edit: invalid level");
+            continue;
+        }
+
+        const size_t level = static_cast<size_t>(a.first);
+
+        if (level >= levels.size()) {
+            levels.resize(level + 1);
+            levelBytes.resize(level + 1, 0ULL);
+        }
+
+        levels[level].push_back(a.second);
+        levelBytes[level] += a.second.fileSize;
+    }
+
+    if (edit.hasNextFileNumber)
+        nextFileNumber = std::max(nextFileNumber, edit.nextFileNumber);
+
+    if (edit.hasLastSequence)
+        lastSequence = std::max(lastSequence, edit.lastSequence);
+}
+
+VersionEdit ManifestManager::snapshot() const {
+
+    VersionEdit edit;
+
+    for (size_t level = 0; level < levels.size(); ++level)
+        for (const auto& meta : levels[level])
+            edit.addFile(static_cast<int>(level), meta);
+
+    edit.setNextFileNumber(nextFileNumber);
+    edit.setLastSequence(lastSequence);
+    return edit;
+}
+
+bool ManifestManager::appendRecord(std::ofstream& out, const VersionEdit& edit) {
+
+    std::string payload;
+    edit.encodeTo(payload);
+
+    std::string record;
+    putU32(record, static_cast<uint32_t>(payload.size()));
+    putU32(record, crc32(payload.data(), payload.size()));
+    record += payload;
+
+    out.write(record.data(), record.size());
+    out.flush();
+
+    if (!out.good()) {
+        LOG_ERROR("Manifest write failed");
+        return false;
+    }
+
+    logBytes += record.size();
+    return true;
+}
+
+void ManifestManager::writeSnapshotLocked() {
+
+    std::filesystem::path dir = std::filesystem::path(manifestPath).parent_path();
+    if (!dir.empty())
+        std::filesystem::create_directories(dir);
+
+    const std::string tempPath = manifestPath + ".tmp";
+
+    {
+        std::ofstream out(tempPath, std::ios::binary | std::ios::trunc);
+
+        if (!out.is_open()) {
+            LOG_ERROR("Manifest save failed: unable to open temp file");
+            return;
+        }
+
+        logBytes = 0;
+        if (!appendRecord(out, snapshot()))
+            return;
+    }
+
+    if (log.is_open())
+        log.close();
+
+    std::error_code ec;
+    std::filesystem::rename(tempPath, manifestPath, ec);
+
+    if (ec) {
+        LOG_ERROR("Manifest rename failed: " + ec.message());
+        return;
+    }
+
+    snapshotBytes = logBytes;
+    log.open(manifestPath, std::ios::binary | std::ios::app);
+
+    LOG_DEBUG("Manifest snapshot written");
+}
+
 void ManifestManager::load() {
 
-    std::ifstream in(manifestPath);
+    std::lock_guard<std::mutex> lock(mtx);
+
+    levels.assign(numLevels, {});
+    levelBytes.assign(numLevels, 0ULL);
+    nextFileNumber = 0;
+    lastSequence = 0;
+
+    std::ifstream in(manifestPath, std::ios::binary);
 
     if (!in.is_open()) {
-        LOG_DEBUG("Manifest load skipped: file not found");
+        if (legacyTextPath.empty() || !loadLegacyText()) {
+            LOG_DEBUG("Manifest load skipped: file not found");
+            return;
+        }
+
+        // Carry the migrated tree over into the new log
+        writeSnapshotLocked();
+        std::filesystem::remove(legacyTextPath);
         return;
     }
 
-    levels.clear();
-    levels.resize(4);
+    size_t edits = 0;
+    std::string payload;
+
+    while (true) {
+        uint32_t header[2];
+
+        if (!in.read(reinterpret_cast<char*>(header), sizeof(header)))
+            break;
 
-    levelBytes.clear();
-    levelBytes.resize(4, 0ULL);
+        const uint32_t length = header[0];
+
+        if (length > MAX_RECORD_BYTES) {
+            LOG_ERROR("Manifest load: damaged record length, ignoring the rest");
+            break;
+        }
+
+        payload.resize(length);
+        if (!in.read(&payload[0], length)) {
+            LOG_ERROR("Manifest load: truncated record, ignoring the rest");
+            break;
+        }
+
+        VersionEdit edit;
+
+        if (crc32(payload.data(), payload.size()) != header[1] ||
+            !VersionEdit::decodeFrom(payload.data(), payload.size(), edit)) {
+            LOG_ERROR("Manifest load: checksum mismatch, ignoring the rest");
+            break;
+        }
+
+        apply(edit);
+        ++edits;
+    }
+
+    in.close();
+
+    LOG_INFO("Manifest loaded successfully (" + std::to_string(edits) + " edits)");
+
+    // Start over from one snapshot; this also drops a damaged tail
+    writeSnapshotLocked();
+}
+
+bool ManifestManager::loadLegacyText() {
+
+    std::ifstream in(legacyTextPath);
+
+    if (!in.is_open())
+        return false;
 
     std::string line;
     int currentLevel = -1;
@@ -39,7 +394,12 @@ void ManifestManager::load() {
             continue;
         }
 
-        if (!line.empty() && currentLevel >= 0 && currentLevel < 4) {
+        if (!line.empty() && currentLevel >= 0) {
+
+            if (currentLevel >= (int)levels.size()) {
+                levels.resize(currentLevel + 1);
+                levelBytes.resize(currentLevel + 1, 0ULL);
+            }
 
             std::stringstream ss(line);
             std::string path, minK, maxK, sizeStr;
@@ -63,105 +423,147 @@ void ManifestManager::load() {
         }
     }
 
-    LOG_INFO("Manifest loaded successfully");
+    LOG_INFO("Migrated text manifest: " + legacyTextPath);
+    return true;
 }
 
-void ManifestManager::save() const {
-
-    std::string tempPath = manifestPath + ".tmp";
-
-    std::ofstream out(tempPath, std::ios::trunc);
-
-    if (!out.is_open()) {
-        LOG_ERROR("Manifest save failed: unable to open temp file");
-        return;
-    }
-
-    for (int level = 0; level < (int)levels.size(); ++level) {
+void ManifestManager::save() {
+    std::lock_guard<std::mutex> lock(mtx);
+    writeSnapshotLocked();
+}
 
-        out << "LEVEL:" << level << "\n";
+void ManifestManager::logAndApply(const VersionEdit& edit) {
 
-        for (const auto& meta : levels[level]) {
-            out << meta.filePath << "|"
-                << meta.minKey << "|"
-                << meta.maxKey << "|"
-                << meta.fileSize << "\n";
-        }
-    }
+    std::lock_guard<std::mutex> lock(mtx);
 
-    out.close();
+    apply(edit);
 
-    std::error_code ec;
-    std::filesystem::rename(tempPath, manifestPath, ec);
-
-    if (ec) {
-        LOG_ERROR("Manifest rename failed: " + ec.message());
+    if (!log.is_open()) {
+        // First change since startup without load(): begin a log
+        writeSnapshotLocked();
         return;
     }
 
-    LOG_DEBUG("Manifest saved successfully");
+    appendRecord(log, edit);
+
+    if (logBytes > std::max(MIN_ROLL_BYTES, ROLL_FACTOR * snapshotBytes))
+        writeSnapshotLocked();
 }
 
 void ManifestManager::addSSTable(int level,
                                  const SSTableMeta& meta) {
 
-    if (level < 0 || level >= (int)levels.size()) {
+    if (level < 0) {
         LOG_ERROR("Manifest addSSTable: invalid level");
         return;
     }
 
-    levels[level].push_back(meta);
-    levelBytes[level] += meta.fileSize;
+    VersionEdit edit;
+    edit.addFile(level, meta);
+    logAndApply(edit);
 
     LOG_DEBUG("SSTable added to manifest at level " + std::to_string(level));
 }
 
 void ManifestManager::removeSSTable(const std::string& filePath) {
 
-    for (int level = 0; level < (int)levels.size(); ++level) {
+    int found = -1;
+    {
+        std::lock_guard<std::mutex> lock(mtx);
+
+        for (int level = 0; level < (int)levels.size() && found < 0; ++level)
+            for (const auto& meta : levels[level])
+                if (meta.filePath == filePath)
+                    found = level;
+    }
 
-        auto& vec = levels[level];
+    if (found < 0)
+        return;
 
-        for (auto it = vec.begin(); it != vec.end(); ++it) {
+    VersionEdit edit;
+    edit.removeFile(found, filePath);
+    logAndApply(edit);
 
-            if (it->filePath == filePath) {
-                levelBytes[level] -= it->fileSize;
-                vec.erase(it);
+    LOG_DEBUG("SSTable removed from manifest: " + filePath);
+}
 
-                LOG_DEBUG("SSTable removed from manifest: " + filePath);
-                return;
-            }
-        }
+void ManifestManager::setLevelOptions(int numLevels,
+                                      std::uint64_t baseBytes,
+                                      double multiplier,
+                                      bool dynamic) {
+
+    std::lock_guard<std::mutex> lock(mtx);
+
+    this->numLevels = std::max(2, numLevels);
+    this->baseBytes = std::max<std::uint64_t>(1, baseBytes);
+    this->multiplier = std::max(2.0, multiplier);
+    this->dynamicLevelBytes = dynamic;
+
+    if ((int)levels.size() < this->numLevels) {
+        levels.resize(this->numLevels);
+        levelBytes.resize(this->numLevels, 0ULL);
     }
 }
 
-std::uint64_t ManifestManager::levelMaxBytes(int level) const {
+int ManifestManager::getNumLevels() const {
+    std::lock_guard<std::mutex> lock(mtx);
+    return static_cast<int>(levels.size());
+}
 
-    const std::uint64_t base = 10ULL * 1024ULL * 1024ULL; // 10MB
+std::uint64_t ManifestManager::levelMaxBytesLocked(int level) const {
 
-    if (level == 0)
-        return base;
+    if (level <= 0)
+        return static_cast<std::uint64_t>(baseBytes / multiplier);
+
+    if (!dynamicLevelBytes) {
+        double size = static_cast<double>(baseBytes);
+        for (int i = 1; i < level; ++i)
+            size *= multiplier;
+        return static_cast<std::uint64_t>(size);
+    }
+
+    // Walk up from the last level while the target stays >= base
+    const int last = static_cast<int>(levels.size()) - 1;
+
+    double target = static_cast<double>(std::max(levelBytes[last], baseBytes));
+    int baseLevel = last;
+
+    while (baseLevel > 1 && target / multiplier >= static_cast<double>(baseBytes)) {
+        target /= multiplier;
+        --baseLevel;
+    }
+
+    if (level < baseLevel)
+        return 0;
+
+    for (int i = baseLevel; i < level; ++i)
+        target *= multiplier;
 
-    std::uint64_t size = base;
-    for (int i = 0; i < level; ++i)
-        size *= 10ULL;
+    return static_cast<std::uint64_t>(target);
+}
 
-    return size;
+std::uint64_t ManifestManager::levelMaxBytes(int level) const {
+    std::lock_guard<std::mutex> lock(mtx);
+    return levelMaxBytesLocked(level);
 }
 
 bool ManifestManager::levelOverflow(int level) const {
 
+    std::lock_guard<std::mutex> lock(mtx);
+
     if (level < 0 || level >= (int)levels.size())
         return false;
 
     if (level == 0)
-        return levels[0].size() > 4;
+        return levels[0].size() > L0_OVERFLOW_FILES;
 
-    return levelBytes[level] > levelMaxBytes(level);
+    return levelBytes[level] > levelMaxBytesLocked(level);
 }
 
 std::uint64_t ManifestManager::levelBytesUsed(int level) const {
 
+    std::lock_guard<std::mutex> lock(mtx);
+
     if (level < 0 || level >= (int)levelBytes.size())
         return 0;
 
@@ -170,6 +572,8 @@ std::uint64_t ManifestManager::levelBytesUsed(int level) const {
 
 std::size_t ManifestManager::levelFileCount(int level) const {
 
+    std::lock_guard<std::mutex> lock(mtx);
+
     if (level < 0 || level >= (int)levels.size())
         return 0;
 
@@ -181,8 +585,20 @@ ManifestManager::getLevels() const {
     return levels;
 }
 
+std::uint64_t ManifestManager::getNextFileNumber() const {
+    std::lock_guard<std::mutex> lock(mtx);
+    return nextFileNumber;
+}
+
+SequenceNumber ManifestManager::getLastSequence() const {
+    std::lock_guard<std::mutex> lock(mtx);
+    return lastSequence;
+}
+
 void ManifestManager::clear() {
 
+    std::lock_guard<std::mutex> lock(mtx);
+
     for (auto& v : levels)
         v.clear();
 
@@ -191,4 +607,4 @@ void ManifestManager::clear() {
               0ULL);
 
     LOG_DEBUG("Manifest cleared");
-}
\ No newline at end of file
+}
@@ -1,51 +1,267 @@
 #include "MemTable.h"
 #include "Logger.h"
 
+#include <algorithm>
+#include <thread>
+
 const std::string MemTable::TOMBSTONE = "__TOMBSTONE__";
 
-MemTable::MemTable(int maxEntries)
-    : maxEntries(maxEntries) {
-    LOG_INFO("MemTable initialized with maxEntries=" + std::to_string(maxEntries));
+// The allocator's chunk header in front of each skiplist node
+static constexpr size_t NODE_ALLOC_OVERHEAD = 2 * sizeof(size_t);
+
+// Heap block behind a string too long for its inline buffer
+static size_t heapBytes(const std::string& s) {
+    static const size_t inlineCapacity = std::string().capacity();
+    return s.capacity() > inlineCapacity ? s.capacity() + 1 + sizeof(size_t) : 0;
+}
+
+MemTable::MemTable(size_t maxBytes,
+                   bool appendOnly,
+                   WriteBufferManager* writeBufferManager)
+    : maxBytes(maxBytes),
+      writeBufferManager(writeBufferManager),
+      appendOnly(appendOnly) {
+    LOG_INFO("MemTable initialized with maxBytes=" + std::to_string(maxBytes) +
+             (appendOnly ? " (append-only)" : ""));
+}
+
+MemTable::~MemTable() {
+    if (!writeBufferManager)
+        return;
+
+    if (!immutable)
+        writeBufferManager->scheduleFreeMem(memoryUsage);
+    writeBufferManager->freeMem(memoryUsage);
+}
+
+void MemTable::charge(size_t bytes) {
+    memoryUsage += bytes;
+    if (writeBufferManager)
+        writeBufferManager->reserveMem(bytes);
 }
 
-void MemTable::put(const std::string& key, const std::string& value){
+void MemTable::markImmutable() {
     std::lock_guard<std::mutex> lock(mtx);
-    table[key] = value;
+
+    if (immutable)
+        return;
+
+    immutable = true;
+    if (writeBufferManager)
+        writeBufferManager->scheduleFreeMem(memoryUsage);
 }
 
-bool MemTable::get(const std::string& key, std::string& value) const{
+static bool entryLess(const std::pair<InternalKey, std::string>& a,
+                      const std::pair<InternalKey, std::string>& b) {
+    return InternalKeyComparator()(a.first, b.first);
+}
+
+void MemTable::put(const Slice& key, const Slice& value, SequenceNumber seq){
     std::lock_guard<std::mutex> lock(mtx);
-    auto it = table.find(key);
-    if(it == table.end()){
+
+    if (appendOnly) {
+        // Growth of the vector is charged when it happens, slack included
+        const size_t capacity = entries.capacity();
+        entries.emplace_back(InternalKey(key, seq), value.toString());
+
+        charge((entries.capacity() - capacity) * sizeof(MemTableVector::value_type) +
+               heapBytes(entries.back().first.userKey) + heapBytes(entries.back().second));
+        return;
+    }
+
+    // Same version replayed twice: the node already there holds it, and
+    // readers may be on it, so it is left alone
+    const SkipList::Node* node = table.insert(key, seq, value);
+    if (!node)
+        return;
+
+    charge(SkipList::nodeSize(node->height) + NODE_ALLOC_OVERHEAD +
+           heapBytes(node->key.userKey) + heapBytes(node->value));
+}
+
+bool MemTable::get(const Slice& key,
+                   std::string& value,
+                   SequenceNumber snapshot,
+                   SequenceNumber* seq) const{
+    if (appendOnly) {
+        std::lock_guard<std::mutex> lock(mtx);
+
+        const MemTableVector::value_type* best = nullptr;
+
+        if (sorted) {
+            auto it = std::lower_bound(
+                entries.begin(), entries.end(), LookupKey{key, snapshot},
+                [](const MemTableVector::value_type& e, const LookupKey& k) {
+                    return InternalKeyComparator()(e.first, k);
+                });
+            if (it != entries.end() && Slice(it->first.userKey) == key)
+                best = &*it;
+        } else {
+            for (const auto& e : entries)
+                if (e.first.sequence <= snapshot && Slice(e.first.userKey) == key &&
+                    (!best || e.first.sequence > best->first.sequence))
+                    best = &e;
+        }
+
+        if (!best)
+            return false;
+
+        value = best->second;
+        if (seq) *seq = best->first.sequence;
+        return true;
+    }
+
+    // First entry for `key` not newer than the snapshot
+    const SkipList::Node* node = table.lowerBound(LookupKey{key, snapshot});
+    if(!node || Slice(node->key.userKey) != key){
         return false;
     }
 
-    value = it->second;
+    value = node->value;
+    if (seq) *seq = node->key.sequence;
     return true;
 }
 
-void MemTable::remove(const std::string& key){
+void MemTable::remove(const Slice& key, SequenceNumber seq){
+    put(key, TOMBSTONE, seq);
+}
+
+void MemTable::addRangeTombstone(const Slice& start,
+                                 const Slice& end,
+                                 SequenceNumber seq){
     std::lock_guard<std::mutex> lock(mtx);
-    table[key] = TOMBSTONE;
+    rangeTombstones.push_back(RangeTombstone{start.toString(), end.toString(), seq});
+
+    charge(sizeof(RangeTombstone) +
+           heapBytes(rangeTombstones.back().start) + heapBytes(rangeTombstones.back().end));
 }
 
-bool MemTable::isFull() const{
+SequenceNumber MemTable::maxCoveringTombstone(const Slice& key,
+                                              SequenceNumber snapshot) const{
     std::lock_guard<std::mutex> lock(mtx);
-    return static_cast<int>(table.size()) >= maxEntries;
+
+    SequenceNumber best = 0;
+
+    for (const auto& t : rangeTombstones) {
+        if (t.seq <= snapshot && t.seq > best &&
+            Slice(t.start) <= key && key < Slice(t.end))
+            best = t.seq;
+    }
+
+    return best;
+}
+
+std::vector<RangeTombstone> MemTable::getRangeTombstones() const{
+    std::lock_guard<std::mutex> lock(mtx);
+    return rangeTombstones;
+}
+
+bool MemTable::isFull() const{
+    return memoryUsage.load() >= maxBytes;
 }
 
 void MemTable::clear(){
     std::lock_guard<std::mutex> lock(mtx);
     table.clear();
+    entries = MemTableVector();
+    sorted = false;
+    rangeTombstones.clear();
+
+    if (writeBufferManager) {
+        if (!immutable)
+            writeBufferManager->scheduleFreeMem(memoryUsage);
+        writeBufferManager->freeMem(memoryUsage);
+    }
+    memoryUsage = 0;
+    immutable = false;
     LOG_DEBUG("MemTable cleared");
 }
 
 bool MemTable::isEmpty() const{
     std::lock_guard<std::mutex> lock(mtx);
-    return table.empty();
+    return table.empty() && entries.empty() && rangeTombstones.empty();
 }
 
-const std::map<std::string, std::string>& MemTable::getData() const{
-    std::lock_guard<std::mutex> lock(mtx);
+const SkipList& MemTable::getData() const{
     return table;
+}
+
+std::shared_ptr<const SkipList> MemTable::snapshotData(const std::string& start,
+                                                       const std::string& end) const{
+    std::lock_guard<std::mutex> lock(mtx);
+
+    auto inRange = [&](const Slice& k) {
+        return k >= Slice(start) && (end.empty() || k <= Slice(end));
+    };
+
+    auto copy = std::make_shared<SkipList>();
+
+    if (!appendOnly) {
+        for (const SkipList::Node* n = table.lowerBound(LookupKey{start, MAX_SEQUENCE_NUMBER});
+             n && inRange(n->key.userKey); n = n->next(0))
+            copy->insert(n->key.userKey, n->key.sequence, n->value);
+        return copy;
+    }
+
+    for (const auto& e : entries)
+        if (inRange(e.first.userKey))
+            copy->insert(e.first.userKey, e.first.sequence, e.second);
+    return copy;
+}
+
+void MemTable::sortEntries(size_t threads){
+    std::lock_guard<std::mutex> lock(mtx);
+
+    if (!appendOnly || sorted)
+        return;
+
+    // Sort equal runs side by side, then merge neighbours pairwise,
+    // again in parallel, until one run is left
+    const size_t n = entries.size();
+    const size_t parts = std::max<size_t>(1, std::min(threads, n / 4096 + 1));
+
+    std::vector<size_t> bounds;
+    for (size_t i = 0; i <= parts; ++i)
+        bounds.push_back(i * n / parts);
+
+    auto at = [&](size_t i) { return entries.begin() + static_cast<std::ptrdiff_t>(i); };
+
+    std::vector<std::thread> workers;
+    for (size_t i = 1; i < parts; ++i)
+        workers.emplace_back([&, i] { std::sort(at(bounds[i]), at(bounds[i + 1]), entryLess); });
+
+    std::sort(at(bounds[0]), at(bounds[1]), entryLess);
+
+    for (auto& w : workers)
+        w.join();
+
+    while (bounds.size() > 2) {
+        std::vector<size_t> next;
+        workers.clear();
+
+        for (size_t i = 0; i + 2 < bounds.size(); i += 2) {
+            const size_t lo = bounds[i], mid = bounds[i + 1], hi = bounds[i + 2];
+            workers.emplace_back([&, lo, mid, hi] {
+                std::inplace_merge(at(lo), at(mid), at(hi), entryLess);
+            });
+            next.push_back(lo);
+        }
+
+        // An odd run out waits for the next round
+        if (bounds.size() % 2 == 0)
+            next.push_back(bounds[bounds.size() - 2]);
+        next.push_back(n);
+
+        for (auto& w : workers)
+            w.join();
+
+        bounds = std::move(next);
+    }
+
+    sorted = true;
+}
+
+const MemTableVector& MemTable::getSortedEntries() const{
+    std::lock_guard<std::mutex> lock(mtx);
+    return entries;
 }
\ No newline at end of file
@@ -1,12 +1,21 @@
 #include "MergeIterator.h"
 
-MergeIterator::MergeIterator(std::vector<Iterator*> inputs){
-    for(size_t i = 0; i < inputs.size(); i++){
-        if (inputs[i] && inputs[i]->valid()) {
-            heap.push({inputs[i], i});
-        }
+MergeIterator::MergeIterator(std::vector<Iterator*> inputs,
+                             SequenceNumber snapshot,
+                             bool keepAllVersions)
+    : children(std::move(inputs)),
+      keys(children.size()),
+      seqs(children.size(), 0),
+      live(children.size(), false),
+      tree(children.size(), 0),
+      snapshot(snapshot),
+      keepAllVersions(keepAllVersions) {
+
+    for (size_t i = 0; i < children.size(); i++) {
+        if (children[i]) loadChild(i);
     }
-    advance();
+
+    build();
 }
 
 
@@ -14,46 +23,133 @@ bool MergeIterator::valid() const{
     return isValid;
 }
 
-const std::string& MergeIterator::key() const{
-    return curKey;
+Slice MergeIterator::key() const{
+    return keys[tree[0]];
 }
 
-const std::string& MergeIterator::value() const{
-    return curValue;
+Slice MergeIterator::value() const{
+    return children[tree[0]]->value();
 }
 
+SequenceNumber MergeIterator::sequence() const{
+    return seqs[tree[0]];
+}
 
-void MergeIterator::next(){
-    advance();
+
+void MergeIterator::seek(const Slice& target){
+    for (size_t i = 0; i < children.size(); i++) {
+        if (!children[i]) continue;
+        children[i]->seek(target);
+        loadChild(i);
+    }
+
+    build();
 }
 
 
-void MergeIterator::advance(){
-    if (heap.empty()) {
+bool MergeIterator::beats(size_t a, size_t b) const{
+    if (!live[a]) return false;
+    if (!live[b]) return true;
+
+    int cmp = keys[a].compare(keys[b]);
+    if (cmp != 0)
+        return cmp < 0;
+
+    if (seqs[a] != seqs[b])
+        return seqs[a] > seqs[b];   // same key: newest version first
+
+    return a < b;   // legacy (unsequenced) files: newer source first
+}
+
+
+void MergeIterator::build(){
+    const size_t n = children.size();
+
+    if (n == 0) {
         isValid = false;
         return;
     }
 
-    Node top = heap.top();
-    heap.pop();
+    // Leaves live at positions [n, 2n); play every match bottom-up
+    std::vector<size_t> winners(2 * n);
+    for (size_t i = 0; i < n; i++)
+        winners[n + i] = i;
 
-    curKey = top.it->key();
-    curValue = top.it->value();
-    isValid = true;
+    for (size_t pos = n - 1; pos >= 1; pos--) {
+        size_t a = winners[2 * pos];
+        size_t b = winners[2 * pos + 1];
 
-    // Skip duplicates with lower priority
-    while(!heap.empty() && heap.top().it->key() == curKey){
-        Node dup = heap.top();
-        heap.pop();
-        dup.it->next();
-        if (dup.it->valid()) {
-            heap.push(dup);
+        if (beats(a, b)) {
+            winners[pos] = a;
+            tree[pos] = b;
+        } else {
+            winners[pos] = b;
+            tree[pos] = a;
         }
     }
 
-    // Advance the chosen iterator
-    top.it->next();
-    if(top.it->valid()){
-        heap.push(top);
+    tree[0] = n == 1 ? 0 : winners[1];
+    isValid = live[tree[0]];
+}
+
+
+void MergeIterator::replay(size_t child){
+    const size_t n = children.size();
+    size_t winner = child;
+
+    for (size_t pos = (child + n) / 2; pos > 0; pos /= 2) {
+        if (beats(tree[pos], winner))
+            std::swap(tree[pos], winner);
+    }
+
+    tree[0] = winner;
+    isValid = live[winner];
+}
+
+
+void MergeIterator::loadChild(size_t child){
+    Iterator* it = children[child];
+
+    while (it->valid() && it->sequence() > snapshot)
+        it->next();
+
+    live[child] = it->valid();
+    if (live[child]) {
+        keys[child] = it->key();
+        seqs[child] = it->sequence();
     }
 }
+
+
+void MergeIterator::advanceChild(size_t child){
+    children[child]->next();
+    loadChild(child);
+    replay(child);
+}
+
+
+void MergeIterator::next(){
+    if (!isValid) return;
+
+    if (keepAllVersions) {
+        advanceChild(tree[0]);
+        return;
+    }
+
+    // Remember the emitted key before its bytes go away
+    const Slice cur = keys[tree[0]];
+    lastKey.assign(cur.data(), cur.size());
+
+    advanceChild(tree[0]);
+    skipDuplicates();
+}
+
+
+void MergeIterator::skipDuplicates(){
+    // Older versions of the emitted key surface next (ties go to the
+    // newer input), so they are dropped as soon as they win
+    const Slice emitted(lastKey);
+
+    while (isValid && keys[tree[0]] == emitted)
+        advanceChild(tree[0]);
+}
@@ -0,0 +1,35 @@
+#include "PerfContext.h"
+
+#include <sstream>
+
+std::string PerfContext::toString() const {
+
+    std::ostringstream out;
+    bool first = true;
+
+    auto field = [&](const char* name, uint64_t value) {
+        if (value == 0) return;
+        out << (first ? "" : ", ") << name << " = " << value;
+        first = false;
+    };
+
+    field("get_nanos", getNanos);
+    field("row_cache_nanos", rowCacheNanos);
+    field("memtable_nanos", memtableNanos);
+    field("bloom_nanos", bloomNanos);
+    field("index_nanos", indexNanos);
+    field("block_read_nanos", blockReadNanos);
+    field("block_decode_nanos", blockDecodeNanos);
+    field("row_cache_hits", rowCacheHits);
+    field("row_cache_misses", rowCacheMisses);
+    field("memtable_hits", memtableHits);
+    field("sstables_touched", sstablesTouched);
+    field("bloom_probes", bloomProbes);
+    field("bloom_hits", bloomHits);
+    field("block_cache_hits", blockCacheHits);
+    field("block_cache_misses", blockCacheMisses);
+    field("blocks_read", blocksRead);
+    field("bytes_read", bytesRead);
+
+    return out.str();
+}
@@ -13,14 +13,24 @@ bool RangeIterator::valid() const{
 }
 
 
-const std::string& RangeIterator::key() const{
+Slice RangeIterator::key() const{
     return base->key();
 }
 
-const std::string& RangeIterator::value() const{
+Slice RangeIterator::value() const{
     return base->value();
 }
 
+SequenceNumber RangeIterator::sequence() const{
+    return base->sequence();
+}
+
+
+void RangeIterator::seek(const Slice& target){
+    const Slice start(startKey);
+    base->seek(target < start ? start : target);
+    advanceToRange();
+}
 
 void RangeIterator::next(){
     base->next();
@@ -28,10 +38,14 @@ void RangeIterator::next(){
 }
 
 void RangeIterator::advanceToRange(){
+    const Slice start(startKey);
+    const Slice end(endKey);
+
     while (base->valid()) {
-        if (base->key() < startKey) {
+        Slice k = base->key();
+        if (k < start) {
             base->next();
-        } else if (!endKey.empty() && base->key() >= endKey){
+        } else if (!end.empty() && k >= end){
             isValid = false;
             return;
         } else {
@@ -0,0 +1,251 @@
+#include "RangeTombstone.h"
+
+#include <algorithm>
+#include <cstring>
+
+FragmentedRangeTombstoneList::FragmentedRangeTombstoneList(
+    const std::vector<RangeTombstone>& tombstones) {
+
+    std::vector<const RangeTombstone*> sorted;
+    std::vector<std::string> bounds;
+
+    for (const auto& t : tombstones) {
+        if (!(Slice(t.start) < Slice(t.end)))
+            continue;   // empty range
+
+        sorted.push_back(&t);
+        bounds.push_back(t.start);
+        bounds.push_back(t.end);
+    }
+
+    std::sort(sorted.begin(), sorted.end(),
+              [](const RangeTombstone* a, const RangeTombstone* b) {
+                  return a->start < b->start;
+              });
+
+    std::sort(bounds.begin(), bounds.end());
+    bounds.erase(std::unique(bounds.begin(), bounds.end()), bounds.end());
+
+    // Sweep the boundaries left to right, keeping the tombstones that
+    // are open at the current one
+    std::vector<const RangeTombstone*> active;
+    size_t next = 0;
+
+    for (size_t b = 0; b + 1 < bounds.size(); b++) {
+
+        const std::string& lo = bounds[b];
+        const std::string& hi = bounds[b + 1];
+
+        while (next < sorted.size() && sorted[next]->start <= lo)
+            active.push_back(sorted[next++]);
+
+        active.erase(std::remove_if(active.begin(), active.end(),
+                                    [&](const RangeTombstone* t) {
+                                        return t->end <= lo;
+                                    }),
+                     active.end());
+
+        if (active.empty())
+            continue;
+
+        Fragment frag{lo, hi, {}};
+        for (const RangeTombstone* t : active)
+            frag.seqs.push_back(t->seq);
+
+        std::sort(frag.seqs.rbegin(), frag.seqs.rend());
+        frag.seqs.erase(std::unique(frag.seqs.begin(), frag.seqs.end()),
+                        frag.seqs.end());
+
+        // Coalesce with an adjacent fragment carrying the same versions
+        if (!fragments.empty() &&
+            fragments.back().end == frag.start &&
+            fragments.back().seqs == frag.seqs) {
+            fragments.back().end = frag.end;
+            continue;
+        }
+
+        fragments.push_back(std::move(frag));
+    }
+}
+
+size_t FragmentedRangeTombstoneList::findFragment(const Slice& key) const {
+
+    // Last fragment with start <= key
+    auto it = std::upper_bound(fragments.begin(), fragments.end(), key,
+                               [](const Slice& k, const Fragment& f) {
+                                   return k < Slice(f.start);
+                               });
+
+    if (it == fragments.begin())
+        return fragments.size();
+
+    --it;
+
+    if (!(key < Slice(it->end)))
+        return fragments.size();
+
+    return static_cast<size_t>(it - fragments.begin());
+}
+
+SequenceNumber FragmentedRangeTombstoneList::maxCoveringSeq(
+    const Slice& key,
+    SequenceNumber snapshot) const {
+
+    size_t idx = findFragment(key);
+    if (idx == fragments.size())
+        return 0;
+
+    for (SequenceNumber s : fragments[idx].seqs) {
+        if (s <= snapshot)
+            return s;
+    }
+
+    return 0;
+}
+
+SequenceNumber FragmentedRangeTombstoneList::nextCoveringSeq(
+    const Slice& key,
+    SequenceNumber seq) const {
+
+    size_t idx = findFragment(key);
+    if (idx == fragments.size())
+        return 0;
+
+    // seqs are newest first: the last one above `seq` is the oldest
+    SequenceNumber result = 0;
+    for (SequenceNumber s : fragments[idx].seqs) {
+        if (s <= seq) break;
+        result = s;
+    }
+
+    return result;
+}
+
+bool FragmentedRangeTombstoneList::coversRange(const Slice& first,
+                                               const Slice& last,
+                                               SequenceNumber seq,
+                                               SequenceNumber snapshot) const {
+
+    size_t idx = findFragment(first);
+
+    while (idx < fragments.size()) {
+
+        const Fragment& frag = fragments[idx];
+
+        bool newer = false;
+        for (SequenceNumber s : frag.seqs) {
+            if (s <= snapshot) {
+                newer = s > seq;
+                break;
+            }
+        }
+
+        if (!newer)
+            return false;
+
+        if (last < Slice(frag.end))
+            return true;
+
+        // Next fragment must continue exactly where this one ends
+        if (idx + 1 == fragments.size() ||
+            fragments[idx + 1].start != frag.end)
+            return false;
+
+        idx++;
+    }
+
+    return false;
+}
+
+const std::string& FragmentedRangeTombstoneList::smallestKey() const {
+    static const std::string none;
+    return fragments.empty() ? none : fragments.front().start;
+}
+
+const std::string& FragmentedRangeTombstoneList::largestKey() const {
+    static const std::string none;
+    return fragments.empty() ? none : fragments.back().end;
+}
+
+void FragmentedRangeTombstoneList::appendTo(
+    std::vector<RangeTombstone>& out) const {
+
+    for (const auto& frag : fragments)
+        for (SequenceNumber s : frag.seqs)
+            out.push_back(RangeTombstone{frag.start, frag.end, s});
+}
+
+// =======================
+// ENCODING
+// =======================
+static void putU32(std::string& out, uint32_t v) {
+    out.append(reinterpret_cast<const char*>(&v), sizeof(v));
+}
+
+static void putU64(std::string& out, uint64_t v) {
+    out.append(reinterpret_cast<const char*>(&v), sizeof(v));
+}
+
+void FragmentedRangeTombstoneList::encodeTo(std::string& out) const {
+
+    putU32(out, static_cast<uint32_t>(fragments.size()));
+
+    for (const auto& frag : fragments) {
+        putU32(out, static_cast<uint32_t>(frag.start.size()));
+        out.append(frag.start);
+        putU32(out, static_cast<uint32_t>(frag.end.size()));
+        out.append(frag.end);
+        putU32(out, static_cast<uint32_t>(frag.seqs.size()));
+        for (SequenceNumber s : frag.seqs)
+            putU64(out, s);
+    }
+}
+
+bool FragmentedRangeTombstoneList::decodeFrom(const char* p,
+                                              size_t n,
+                                              FragmentedRangeTombstoneList& out) {
+
+    const char* limit = p + n;
+
+    auto getU32 = [&](uint32_t& v) {
+        if (limit - p < static_cast<std::ptrdiff_t>(sizeof(v))) return false;
+        std::memcpy(&v, p, sizeof(v));
+        p += sizeof(v);
+        return true;
+    };
+
+    auto getBytes = [&](std::string& s) {
+        uint32_t len;
+        if (!getU32(len) || static_cast<size_t>(limit - p) < len) return false;
+        s.assign(p, len);
+        p += len;
+        return true;
+    };
+
+    uint32_t count;
+    if (!getU32(count))
+        return false;
+
+    out.fragments.clear();
+    out.fragments.reserve(count);
+
+    for (uint32_t i = 0; i < count; i++) {
+
+        Fragment frag;
+        uint32_t seqCount;
+
+        if (!getBytes(frag.start) || !getBytes(frag.end) || !getU32(seqCount))
+            return false;
+
+        if (static_cast<size_t>(limit - p) < seqCount * sizeof(uint64_t))
+            return false;
+
+        frag.seqs.resize(seqCount);
+        std::memcpy(frag.seqs.data(), p, seqCount * sizeof(uint64_t));
+        p += seqCount * sizeof(uint64_t);
+
+        out.fragments.push_back(std::move(frag));
+    }
+
+    return true;
+}
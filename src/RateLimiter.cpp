@@ -0,0 +1,165 @@
+#include "RateLimiter.h"
+
+#include <algorithm>
+
+RateLimiter::RateLimiter(const RateLimiterOptions& options) {
+    setOptions(options);
+}
+
+void RateLimiter::setOptions(const RateLimiterOptions& options) {
+    {
+        std::lock_guard<std::mutex> lock(mtx);
+
+        this->options = options;
+        rate = options.bytesPerSecond;
+        available = static_cast<double>(burstBytes());
+        lastRefill = Clock::now();
+        lastTune = lastRefill;
+        counters.bytesPerSecond = rate;
+    }
+
+    granted.notify_all();
+}
+
+bool RateLimiter::isEnabled() const {
+    std::lock_guard<std::mutex> lock(mtx);
+    return rate != 0;
+}
+
+uint64_t RateLimiter::getBytesPerSecond() const {
+    std::lock_guard<std::mutex> lock(mtx);
+    return rate;
+}
+
+RateLimiterStats RateLimiter::getStats() const {
+    std::lock_guard<std::mutex> lock(mtx);
+    return counters;
+}
+
+uint64_t RateLimiter::burstBytes() const {
+    return std::max<uint64_t>(
+        1, rate * REFILL_PERIOD.count() / 1000);
+}
+
+void RateLimiter::refill(Clock::time_point now) {
+    const double elapsed = std::chrono::duration<double>(now - lastRefill).count();
+    lastRefill = now;
+
+    available = std::min(available + elapsed * rate,
+                         static_cast<double>(burstBytes()));
+}
+
+const void* RateLimiter::nextWaiter() const {
+    for (const auto& queue : queues)
+        if (!queue.empty())
+            return queue.front();
+    return nullptr;
+}
+
+// =======================
+// REQUEST
+// =======================
+void RateLimiter::request(uint64_t bytes, IOPriority priority) {
+
+    const size_t p = static_cast<size_t>(priority);
+
+    std::unique_lock<std::mutex> lock(mtx);
+
+    counters.bytes[p] += bytes;
+    counters.requests[p]++;
+
+    if (rate == 0)
+        return;
+
+    const Clock::time_point start = Clock::now();
+    bool waited = false;
+
+    while (bytes > 0 && rate != 0) {
+
+        const uint64_t chunk = std::min(bytes, burstBytes());
+
+        // Our place in line; any unique address will do
+        const char self = 0;
+        queues[p].push_back(&self);
+
+        while (rate != 0) {
+            refill(Clock::now());
+
+            if (nextWaiter() == &self && available >= chunk)
+                break;
+
+            waited = true;
+
+            if (nextWaiter() == &self) {
+                const double missing = chunk - available;
+                granted.wait_for(lock, std::chrono::duration<double>(missing / rate));
+            } else {
+                granted.wait(lock);
+            }
+        }
+
+        queues[p].erase(std::find(queues[p].begin(), queues[p].end(), &self));
+
+        available -= chunk;
+        bytes -= chunk;
+
+        // The next waiter may be able to go now
+        granted.notify_all();
+    }
+
+    if (waited)
+        counters.waitNanos[p] += std::chrono::duration_cast<std::chrono::nanoseconds>(
+            Clock::now() - start).count();
+}
+
+// =======================
+// AUTO-TUNE
+// =======================
+bool RateLimiter::tuneDue() const {
+    std::lock_guard<std::mutex> lock(mtx);
+    return options.autoTune && rate != 0 &&
+           Clock::now() - lastTune >= TUNE_INTERVAL;
+}
+
+void RateLimiter::tune(double debtRatio, uint64_t readP99Nanos) {
+
+    {
+        std::lock_guard<std::mutex> lock(mtx);
+
+        const Clock::time_point now = Clock::now();
+
+        if (!options.autoTune || rate == 0 || now - lastTune < TUNE_INTERVAL)
+            return;
+
+        lastTune = now;
+
+        // Slow-moving reference for "normal" read latency
+        double latencyRatio = 1.0;
+
+        if (readP99Nanos > 0) {
+            if (baselineReadP99 == 0)
+                baselineReadP99 = static_cast<double>(readP99Nanos);
+
+            latencyRatio = readP99Nanos / baselineReadP99;
+            baselineReadP99 = 0.9 * baselineReadP99 + 0.1 * readP99Nanos;
+        }
+
+        double next = static_cast<double>(rate);
+
+        // Falling behind costs write stalls later; that wins over reads
+        if (debtRatio >= 0.5)
+            next *= 1.25;
+        else if (latencyRatio > 1.5)
+            next *= 0.8;
+
+        refill(now);
+
+        rate = std::clamp<uint64_t>(static_cast<uint64_t>(next),
+                                    options.minBytesPerSecond,
+                                    std::max(options.minBytesPerSecond,
+                                             options.maxBytesPerSecond));
+        counters.bytesPerSecond = rate;
+    }
+
+    granted.notify_all();
+}
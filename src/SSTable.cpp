@@ -1,11 +1,14 @@
 #include "SSTable.h"
 #include "Logger.h"
+#include "PerfContext.h"
 
 #include <fstream>
 #include <vector>
+#include <cstring>
 #include "MemTable.h"
 
-struct SSTableFooter {
+// v1 footer: same fields without metaOffset
+struct SSTableFooterV1 {
     uint64_t indexOffset;
     uint64_t minKeyOffset;
     uint64_t maxKeyOffset;
@@ -16,6 +19,95 @@ struct SSTableFooter {
 // BLOCK SIZE (NEW)
 constexpr size_t BLOCK_SIZE = 4;
 
+static const char* PROPERTIES_BLOCK = "properties";
+static const char* RANGE_DEL_BLOCK = "rangedel";
+
+// =======================
+// Footer (either version)
+// =======================
+bool SSTable::readFooter(std::ifstream& in, SSTableFooter& footer) {
+
+    in.seekg(0, std::ios::end);
+    std::streamoff size = in.tellg();
+
+    if (size < static_cast<std::streamoff>(sizeof(SSTableFooterV1)))
+        return false;
+
+    uint64_t magic = 0;
+    in.seekg(-static_cast<std::streamoff>(sizeof(magic)), std::ios::end);
+    in.read(reinterpret_cast<char*>(&magic), sizeof(magic));
+
+    if (magic == SSTABLE_MAGIC_V2 &&
+        size >= static_cast<std::streamoff>(sizeof(SSTableFooter))) {
+
+        in.seekg(-static_cast<std::streamoff>(sizeof(SSTableFooter)), std::ios::end);
+        in.read(reinterpret_cast<char*>(&footer), sizeof(footer));
+        return in.good();
+    }
+
+    if (magic == SSTABLE_MAGIC) {
+
+        SSTableFooterV1 v1;
+        in.seekg(-static_cast<std::streamoff>(sizeof(v1)), std::ios::end);
+        in.read(reinterpret_cast<char*>(&v1), sizeof(v1));
+
+        footer = SSTableFooter{v1.indexOffset, v1.minKeyOffset,
+                               v1.maxKeyOffset, v1.fileSize, 0, v1.magic};
+        return in.good();
+    }
+
+    return false;
+}
+
+// =======================
+// Record decoding (shared by get and SSTableIterator)
+// =======================
+bool SSTable::decodeRecord(const char*& p,
+                           const char* limit,
+                           bool tagged,
+                           SSTableRecord& rec,
+                           SequenceNumber globalSeq) {
+
+    uint32_t k, v;
+    const size_t tagSize = tagged ? sizeof(uint64_t) : 0;
+
+    if (limit - p < static_cast<std::ptrdiff_t>(sizeof(k)))
+        return false;
+
+    std::memcpy(&k, p, sizeof(k));
+
+    if (static_cast<size_t>(limit - p) < sizeof(k) + k + tagSize + sizeof(v))
+        return false;
+
+    const char* keyData = p + sizeof(k);
+
+    uint64_t tag = 0;
+    if (tagged)
+        std::memcpy(&tag, keyData + k, sizeof(tag));
+
+    std::memcpy(&v, keyData + k + tagSize, sizeof(v));
+
+    const char* valData = keyData + k + tagSize + sizeof(v);
+
+    if (static_cast<size_t>(limit - valData) < v)
+        return false;
+
+    rec.key = Slice(keyData, k);
+    rec.value = Slice(valData, v);
+
+    // v1 files have no versions; deletions are the TOMBSTONE value
+    rec.tag = tagged ? tag
+                     : packSequenceAndType(0, rec.value == MemTable::TOMBSTONE
+                                                  ? ValueType::DELETION
+                                                  : ValueType::VALUE);
+
+    if (globalSeq)
+        rec.tag = packSequenceAndType(globalSeq, tagType(rec.tag));
+
+    p = valData + v;
+    return true;
+}
+
 // =======================
 // Constructor 
 // =======================
@@ -35,16 +127,7 @@ SSTable::SSTable(const std::string& filePath,
     }
 
     loadFooterMetadata();
-
-    uint64_t indexOffset = 0;
-    {
-        std::ifstream fin(filePath, std::ios::binary);
-        fin.seekg(-static_cast<std::streamoff>(sizeof(SSTableFooter)), std::ios::end);
-
-        SSTableFooter footer;
-        fin.read(reinterpret_cast<char*>(&footer), sizeof(footer));
-        indexOffset = footer.indexOffset;
-    }
+    loadSparseIndex();
 
     in.seekg(0);
 
@@ -59,6 +142,9 @@ SSTable::SSTable(const std::string& filePath,
         std::string key(k, '\0');
         in.read(&key[0], k);
 
+        if (tagged)
+            in.seekg(sizeof(uint64_t), std::ios::cur);
+
         if (!in.read(reinterpret_cast<char*>(&v), sizeof(v)))
             break;
 
@@ -75,17 +161,16 @@ void SSTable::loadFooterMetadata() {
     if (!in.is_open())
         return;
 
-    in.seekg(-static_cast<std::streamoff>(sizeof(SSTableFooter)), std::ios::end);
-
     SSTableFooter footer;
-    in.read(reinterpret_cast<char*>(&footer), sizeof(footer));
 
-    if (footer.magic != SSTABLE_MAGIC) {
+    if (!readFooter(in, footer)) {
         LOG_ERROR("SSTable footer magic mismatch: " + filePath);
         return;
     }
 
     fileSize = footer.fileSize;
+    indexOffset = footer.indexOffset;
+    tagged = footer.magic == SSTABLE_MAGIC_V2;
 
     in.seekg(footer.minKeyOffset);
     uint32_t minSize;
@@ -98,10 +183,174 @@ void SSTable::loadFooterMetadata() {
     in.read(reinterpret_cast<char*>(&maxSize), sizeof(maxSize));
     maxKey.resize(maxSize);
     in.read(&maxKey[0], maxSize);
+
+    if (footer.metaOffset != 0)
+        loadMetaBlocks(footer.metaOffset);
+}
+
+// =======================
+// META BLOCKS: [u32 count] { [u32 nameLen][name][u64 len][payload] }
+// =======================
+void SSTable::loadMetaBlocks(uint64_t metaOffset) {
+
+    std::ifstream in(filePath, std::ios::binary);
+    if (!in.is_open())
+        return;
+
+    in.seekg(metaOffset);
+
+    uint32_t blockCount = 0;
+    in.read(reinterpret_cast<char*>(&blockCount), sizeof(blockCount));
+
+    for (uint32_t b = 0; b < blockCount && in.good(); b++) {
+
+        uint32_t nameLen;
+        uint64_t len;
+
+        in.read(reinterpret_cast<char*>(&nameLen), sizeof(nameLen));
+        std::string name(nameLen, '\0');
+        in.read(&name[0], nameLen);
+        in.read(reinterpret_cast<char*>(&len), sizeof(len));
+
+        if (name == RANGE_DEL_BLOCK) {
+
+            std::string payload(len, '\0');
+            in.read(&payload[0], len);
+
+            auto list = std::make_shared<FragmentedRangeTombstoneList>();
+
+            if (!FragmentedRangeTombstoneList::decodeFrom(payload.data(),
+                                                         payload.size(),
+                                                         *list)) {
+                LOG_ERROR("Corrupt range tombstone block: " + filePath);
+                continue;
+            }
+
+            if (!list->empty())
+                rangeTombstones = std::move(list);
+            continue;
+        }
+
+        if (name != PROPERTIES_BLOCK) {
+            in.seekg(len, std::ios::cur);   // unknown block: skip
+            continue;
+        }
+
+        uint32_t count = 0;
+        in.read(reinterpret_cast<char*>(&count), sizeof(count));
+
+        for (uint32_t i = 0; i < count && in.good(); i++) {
+
+            uint32_t n;
+            uint64_t value;
+
+            in.read(reinterpret_cast<char*>(&n), sizeof(n));
+            std::string prop(n, '\0');
+            in.read(&prop[0], n);
+            in.read(reinterpret_cast<char*>(&value), sizeof(value));
+
+            if (prop == "seq.smallest")      properties.smallestSeq = value;
+            else if (prop == "seq.largest")  properties.largestSeq = value;
+            else if (prop == "num.entries")  properties.numEntries = value;
+            else if (prop == "num.deletions") properties.numDeletions = value;
+            else if (prop == "dead.bytes")   properties.deadBytes = value;
+            else if (prop == "num.range_deletions")
+                properties.numRangeDeletions = value;
+        }
+    }
+}
+
+void SSTable::setGlobalSequence(SequenceNumber seq) {
+
+    globalSeq = seq;
+
+    if (seq) {
+        properties.smallestSeq = seq;
+        properties.largestSeq = seq;
+    }
+}
+
+size_t SSTable::approximateMemoryUsage() const {
+
+    size_t bytes = sizeof(SSTable) + bloom.memoryUsage() +
+                   filePath.capacity() + minKey.capacity() + maxKey.capacity();
+
+    if (sparseIndex) {
+        bytes += sparseIndex->capacity() * sizeof(SSTableIndexEntry);
+        for (const SSTableIndexEntry& e : *sparseIndex)
+            bytes += e.key.capacity();
+    }
+
+    if (rangeTombstones)
+        for (const auto& f : rangeTombstones->getFragments())
+            bytes += sizeof(f) + f.start.capacity() + f.end.capacity() +
+                     f.seqs.capacity() * sizeof(SequenceNumber);
+
+    return bytes;
+}
+
+uint64_t SSTable::estimatedDeadBytes() const {
+
+    if (properties.numEntries == 0)
+        return 0;
+
+    const uint64_t avgRecord = fileSize / properties.numEntries;
+
+    return std::min(properties.deadBytes, fileSize) +
+           properties.numDeletions * avgRecord;
+}
+
+// =======================
+void SSTable::loadSparseIndex() {
+
+    auto index = std::make_shared<SSTableIndex>();
+    sparseIndex = index;
+
+    std::ifstream in(filePath, std::ios::binary);
+    if (!in.is_open() || indexOffset == 0)
+        return;
+
+    in.seekg(indexOffset);
+
+    uint32_t indexCount = 0;
+    in.read(reinterpret_cast<char*>(&indexCount), sizeof(indexCount));
+
+    index->reserve(indexCount);
+
+    for (uint32_t i = 0; i < indexCount && in.good(); i++) {
+        uint32_t k;
+        uint64_t off;
+
+        in.read(reinterpret_cast<char*>(&k), sizeof(k));
+        std::string ik(k, '\0');
+        in.read(&ik[0], k);
+        in.read(reinterpret_cast<char*>(&off), sizeof(off));
+
+        index->emplace_back(ik, off);
+    }
+}
+
+// =======================
+size_t SSTable::findBlock(const SSTableIndex& index, const Slice& key) {
+
+    int left = 0, right = static_cast<int>(index.size()) - 1;
+    size_t blockIdx = 0;
+
+    while (left <= right) {
+        int mid = (left + right) / 2;
+        if (Slice(index[mid].key) < key) {
+            blockIdx = mid;
+            left = mid + 1;
+        } else {
+            right = mid - 1;
+        }
+    }
+
+    return blockIdx;
 }
 
 // =======================
-bool SSTable::mightContain(const std::string& key) const {
+bool SSTable::mightContain(const Slice& key) const {
 
     if (statsHook) statsHook->recordBloomCheck();
 
@@ -119,72 +368,152 @@ bool SSTable::isBinarySSTable() const {
     if (!in.is_open())
         return false;
 
-    in.seekg(0, std::ios::end);
-    std::streamoff size = in.tellg();
-
-    if (size < static_cast<std::streamoff>(sizeof(SSTableFooter)))
-        return false;
-
-    in.seekg(-static_cast<std::streamoff>(sizeof(SSTableFooter)), std::ios::end);
-
     SSTableFooter footer;
-    in.read(reinterpret_cast<char*>(&footer), sizeof(footer));
+    return readFooter(in, footer);
+}
 
-    return footer.magic == SSTABLE_MAGIC;
+// =======================
+void SSTable::appendKV(const Slice& key,
+                       uint64_t tag,
+                       const Slice& value,
+                       std::ofstream& out) {
+
+    uint32_t k = key.size();
+    uint32_t v = value.size();
+
+    out.write(reinterpret_cast<char*>(&k), sizeof(k));
+    out.write(key.data(), k);
+    out.write(reinterpret_cast<char*>(&tag), sizeof(tag));
+    out.write(reinterpret_cast<char*>(&v), sizeof(v));
+    out.write(value.data(), v);
 }
 
 // =======================
-//UPDATED: BLOCK INDEX WRITE
+//UPDATED: BLOCK INDEX WRITE (streaming)
 // =======================
-bool SSTable::writeToDisk(const std::map<std::string, std::string>& data) {
+// Rate-limited writes are charged in pieces of about this size
+static constexpr uint64_t RATE_LIMIT_CHARGE_BYTES = 64 * 1024;
+
+bool SSTable::writeToDisk(Iterator& input,
+                          const FragmentedRangeTombstoneList* rangeDels) {
+
+    Build build;
+    if (!beginBuild(build))
+        return false;
+
+    for (; input.valid(); input.next())
+        addToBuild(build, input.key(), input.sequence(), input.value());
+
+    return finishBuild(build, rangeDels);
+}
 
-    std::ofstream out(filePath, std::ios::binary | std::ios::trunc);
-    if (!out.is_open()) {
+bool SSTable::beginBuild(Build& build) {
+
+    build.out.open(filePath, std::ios::binary | std::ios::trunc);
+    if (!build.out.is_open()) {
         LOG_ERROR("Failed to create SSTable: " + filePath);
         return false;
     }
 
-    sparseIndex.clear();
+    build.index = std::make_shared<SSTableIndex>();
+    properties = SSTableProperties();
+    tagged = true;
 
-    std::string localMinKey;
-    std::string localMaxKey;
-    bool first = true;
+    return true;
+}
 
-    size_t entryCount = 0;
+void SSTable::addToBuild(Build& build,
+                         const Slice& key,
+                         SequenceNumber seq,
+                         const Slice& value) {
 
-    for (const auto& entry : data) {
+    std::ofstream& out = build.out;
 
-        if (first) {
-            localMinKey = entry.first;
-            first = false;
-        }
-        localMaxKey = entry.first;
+    // Older version of the key just written
+    const bool shadowed = !build.first && key == Slice(build.maxKey);
+
+    if (build.first) {
+        build.minKey.assign(key.data(), key.size());
+        build.first = false;
+    }
+    // assign() reuses capacity, so this rarely allocates
+    build.maxKey.assign(key.data(), key.size());
+
+    // BLOCK INDEX
+    if (build.entryCount % BLOCK_SIZE == 0) {
+        uint64_t offset = static_cast<uint64_t>(out.tellp());
+        build.index->emplace_back(build.maxKey, offset);
 
-        // BLOCK INDEX
-        if (entryCount % BLOCK_SIZE == 0) {
-            uint64_t offset = static_cast<uint64_t>(out.tellp());
-            sparseIndex.emplace_back(entry.first, offset);
+        if (rateLimiter && offset - build.charged >= RATE_LIMIT_CHARGE_BYTES) {
+            rateLimiter->request(offset - build.charged, ioPriority);
+            build.charged = offset;
         }
+    }
 
-        entryCount++;
+    build.entryCount++;
 
-        uint32_t k = entry.first.size();
-        uint32_t v = entry.second.size();
+    ValueType type = value == MemTable::TOMBSTONE ? ValueType::DELETION
+                                                  : ValueType::VALUE;
 
-        out.write(reinterpret_cast<char*>(&k), sizeof(k));
-        out.write(entry.first.data(), k);
-        out.write(reinterpret_cast<char*>(&v), sizeof(v));
-        out.write(entry.second.data(), v);
+    appendKV(key, packSequenceAndType(seq, type), value, out);
+
+    if (type == ValueType::DELETION)
+        properties.numDeletions++;
 
-        bloom.add(entry.first);
+    if (type == ValueType::DELETION || shadowed)
+        properties.deadBytes += 2 * sizeof(uint32_t) + sizeof(uint64_t) +
+                                key.size() + value.size();
+
+    if (build.entryCount == 1 || seq < properties.smallestSeq)
+        properties.smallestSeq = seq;
+    if (seq > properties.largestSeq)
+        properties.largestSeq = seq;
+
+    bloom.add(key);
+}
+
+bool SSTable::finishBuild(Build& build,
+                          const FragmentedRangeTombstoneList* rangeDels) {
+
+    std::ofstream& out = build.out;
+    std::string& localMinKey = build.minKey;
+    std::string& localMaxKey = build.maxKey;
+    const bool first = build.first;
+    const size_t entryCount = build.entryCount;
+    auto& index = build.index;
+
+    properties.numEntries = entryCount;
+
+    // Range tombstones extend the key range (end is exclusive, so using
+    // it as an inclusive bound only over-approximates) and the seq range
+    if (rangeDels && !rangeDels->empty()) {
+
+        if (first || Slice(rangeDels->smallestKey()) < Slice(localMinKey))
+            localMinKey = rangeDels->smallestKey();
+        if (first || Slice(rangeDels->largestKey()) > Slice(localMaxKey))
+            localMaxKey = rangeDels->largestKey();
+
+        bool seqSeen = entryCount > 0;
+
+        for (const auto& frag : rangeDels->getFragments()) {
+            for (SequenceNumber s : frag.seqs) {
+                if (!seqSeen || s < properties.smallestSeq)
+                    properties.smallestSeq = s;
+                if (s > properties.largestSeq)
+                    properties.largestSeq = s;
+                seqSeen = true;
+            }
+        }
+
+        properties.numRangeDeletions = rangeDels->size();
     }
 
-    uint64_t indexOffset = static_cast<uint64_t>(out.tellp());
-    uint32_t indexCount = sparseIndex.size();
+    indexOffset = static_cast<uint64_t>(out.tellp());
+    uint32_t indexCount = index->size();
 
     out.write(reinterpret_cast<char*>(&indexCount), sizeof(indexCount));
 
-    for (const auto& e : sparseIndex) {
+    for (const auto& e : *index) {
         uint32_t k = e.key.size();
         out.write(reinterpret_cast<char*>(&k), sizeof(k));
         out.write(e.key.data(), k);
@@ -201,6 +530,56 @@ bool SSTable::writeToDisk(const std::map<std::string, std::string>& data) {
     out.write(reinterpret_cast<char*>(&maxSize), sizeof(maxSize));
     out.write(localMaxKey.data(), maxSize);
 
+    // Meta blocks: "properties", then "rangedel" if there are any
+    uint64_t metaOffset = static_cast<uint64_t>(out.tellp());
+
+    const std::pair<const char*, uint64_t> props[] = {
+        {"seq.smallest", properties.smallestSeq},
+        {"seq.largest", properties.largestSeq},
+        {"num.entries", properties.numEntries},
+        {"num.deletions", properties.numDeletions},
+        {"dead.bytes", properties.deadBytes},
+        {"num.range_deletions", properties.numRangeDeletions}
+    };
+
+    std::string payload;
+    uint32_t propCount = sizeof(props) / sizeof(props[0]);
+    payload.append(reinterpret_cast<const char*>(&propCount), sizeof(propCount));
+
+    for (const auto& prop : props) {
+        uint32_t n = std::strlen(prop.first);
+        payload.append(reinterpret_cast<const char*>(&n), sizeof(n));
+        payload.append(prop.first, n);
+        payload.append(reinterpret_cast<const char*>(&prop.second), sizeof(prop.second));
+    }
+
+    std::vector<std::pair<const char*, std::string>> metaBlocks;
+    metaBlocks.emplace_back(PROPERTIES_BLOCK, std::move(payload));
+
+    rangeTombstones.reset();
+
+    if (rangeDels && !rangeDels->empty()) {
+        std::string encoded;
+        rangeDels->encodeTo(encoded);
+        metaBlocks.emplace_back(RANGE_DEL_BLOCK, std::move(encoded));
+
+        rangeTombstones =
+            std::make_shared<FragmentedRangeTombstoneList>(*rangeDels);
+    }
+
+    uint32_t blockCount = metaBlocks.size();
+    out.write(reinterpret_cast<char*>(&blockCount), sizeof(blockCount));
+
+    for (const auto& block : metaBlocks) {
+        uint32_t nameLen = std::strlen(block.first);
+        uint64_t payloadLen = block.second.size();
+
+        out.write(reinterpret_cast<char*>(&nameLen), sizeof(nameLen));
+        out.write(block.first, nameLen);
+        out.write(reinterpret_cast<char*>(&payloadLen), sizeof(payloadLen));
+        out.write(block.second.data(), block.second.size());
+    }
+
     uint64_t finalSize = static_cast<uint64_t>(out.tellp());
 
     SSTableFooter footer{
@@ -208,105 +587,135 @@ bool SSTable::writeToDisk(const std::map<std::string, std::string>& data) {
         minKeyOffset,
         maxKeyOffset,
         finalSize,
-        SSTABLE_MAGIC
+        metaOffset,
+        SSTABLE_MAGIC_V2
     };
 
     out.write(reinterpret_cast<char*>(&footer), sizeof(footer));
 
+    if (rateLimiter)
+        rateLimiter->request(finalSize + sizeof(footer) - build.charged, ioPriority);
+
     out.close();
+
+    if (!out) {
+        LOG_ERROR("Failed to write SSTable: " + filePath);
+        return false;
+    }
+
+    sparseIndex = std::move(index);
+    minKey = localMinKey;
+    maxKey = localMaxKey;
+    fileSize = finalSize;
+
     return true;
 }
 
 // =======================
-// UPDATED: BLOCK LIMITED SEARCH
+// BLOCK READ (shared, cacheable)
 // =======================
-GetResult SSTable::getBinary(const std::string& key,
-                             std::string& value) const {
+std::shared_ptr<const std::string> SSTable::readBlock(size_t blockIdx,
+                                                     uint64_t* bytesRead) const {
+
+    const SSTableIndex& index = *sparseIndex;
+
+    uint64_t start = index[blockIdx].offset;
+    uint64_t end = blockIdx + 1 < index.size()
+                       ? index[blockIdx + 1].offset
+                       : indexOffset;
+
+    PERF_TIMER_GUARD(blockReadNanos);
+
+    std::string cacheKey;
+    std::shared_ptr<const std::string> block;
+
+    if (blockCache) {
+        cacheKey = BlockCache::blockKey(filePath, start);
+        if (blockCache->get(cacheKey, block))
+            return block;
+    }
 
     std::ifstream in(filePath, std::ios::binary);
-    if (!in.is_open())
-        return GetResult::NOT_FOUND;
+    if (!in.is_open() || end < start)
+        return nullptr;
 
-    in.seekg(-static_cast<std::streamoff>(sizeof(SSTableFooter)), std::ios::end);
+    auto buf = std::make_shared<std::string>(end - start, '\0');
 
-    SSTableFooter footer;
-    in.read(reinterpret_cast<char*>(&footer), sizeof(footer));
+    in.seekg(start);
+    if (!in.read(&(*buf)[0], buf->size()))
+        return nullptr;
 
-    if (footer.magic != SSTABLE_MAGIC)
-        return GetResult::NOT_FOUND;
+    PERF_COUNTER_ADD(blocksRead, 1);
+    PERF_COUNTER_ADD(bytesRead, buf->size());
 
-    in.seekg(footer.indexOffset);
+    if (bytesRead)
+        *bytesRead += buf->size();
 
-    uint32_t indexCount;
-    in.read(reinterpret_cast<char*>(&indexCount), sizeof(indexCount));
+    block = std::move(buf);
 
-    std::vector<SSTableIndexEntry> localIndex;
-    localIndex.reserve(indexCount);
+    if (blockCache)
+        blockCache->put(cacheKey, block);
 
-    for (uint32_t i = 0; i < indexCount; i++) {
-        uint32_t k;
-        uint64_t off;
+    return block;
+}
 
-        in.read(reinterpret_cast<char*>(&k), sizeof(k));
-        std::string ik(k, '\0');
-        in.read(&ik[0], k);
-        in.read(reinterpret_cast<char*>(&off), sizeof(off));
+// =======================
+// BLOCK LIMITED SEARCH (in-memory index, no value copy)
+// =======================
+GetResult SSTable::getBinary(const Slice& key,
+                             PinnableSlice& value,
+                             SequenceNumber snapshot,
+                             SequenceNumber* seq,
+                             uint64_t* bytesRead) const {
 
-        localIndex.emplace_back(ik, off);
-    }
+    const SSTableIndex& index = *sparseIndex;
+
+    if (index.empty())
+        return GetResult::NOT_FOUND;
 
-    //Binary search
-    int left = 0, right = localIndex.size() - 1;
-    uint64_t startOffset = 0;
+    bool passed = false;
 
-    while (left <= right) {
-        int mid = (left + right) / 2;
-        if (localIndex[mid].key <= key) {
-            startOffset = localIndex[mid].offset;
-            left = mid + 1;
-        } else {
-            right = mid - 1;
-        }
-    }
+    PerfTimer indexTimer(&PerfContext::indexNanos);
+    size_t first = findBlock(index, key);
+    indexTimer.stop();
+
+    for (size_t b = first; b < index.size() && !passed; b++) {
 
-    //Find next block boundary
-    uint64_t nextBlockOffset = footer.indexOffset;
-    for (const auto& e : localIndex) {
-        if (e.offset > startOffset) {
-            nextBlockOffset = e.offset;
+        if (Slice(index[b].key) > key)
             break;
-        }
-    }
 
-    in.seekg(startOffset);
+        std::shared_ptr<const std::string> block = readBlock(b, bytesRead);
+        if (!block)
+            break;
 
-    while (in.good() &&
-           static_cast<uint64_t>(in.tellg()) < nextBlockOffset) {
+        PERF_TIMER_GUARD(blockDecodeNanos);
 
-        uint32_t k, v;
+        const char* p = block->data();
+        const char* limit = p + block->size();
 
-        if (!in.read(reinterpret_cast<char*>(&k), sizeof(k)))
-            break;
+        SSTableRecord rec;
 
-        std::string curKey(k, '\0');
-        in.read(&curKey[0], k);
+        while (decodeRecord(p, limit, tagged, rec, globalSeq)) {
 
-        if (!in.read(reinterpret_cast<char*>(&v), sizeof(v)))
-            break;
+            int cmp = key.compare(rec.key);
 
-        std::string curVal(v, '\0');
-        in.read(&curVal[0], v);
+            if (cmp < 0) {
+                passed = true;
+                break;
+            }
 
-        if (curKey == key) {
-            if (curVal == MemTable::TOMBSTONE)
-                return GetResult::DELETED;
+            // Newest first: the first version inside the snapshot wins
+            if (cmp == 0 && rec.sequence() <= snapshot) {
 
-            value = curVal;
-            return GetResult::FOUND;
-        }
+                if (seq) *seq = rec.sequence();
 
-        if (curKey > key)
-            break;
+                if (tagType(rec.tag) == ValueType::DELETION)
+                    return GetResult::DELETED;
+
+                value.pinSlice(block, rec.value.data(), rec.value.size());
+                return GetResult::FOUND;
+            }
+        }
     }
 
     if (statsHook) statsHook->recordBloomFalsePositive();
@@ -315,13 +724,30 @@ GetResult SSTable::getBinary(const std::string& key,
 }
 
 // =======================
-GetResult SSTable::get(const std::string& key,
-                       std::string& value) const {
+GetResult SSTable::get(const Slice& key,
+                       PinnableSlice& value,
+                       SequenceNumber snapshot,
+                       SequenceNumber* seq,
+                       uint64_t* bytesRead) const {
 
-    if (!minKey.empty() && (key < minKey || key > maxKey))
+    if (!minKey.empty() && (key < Slice(minKey) || key > Slice(maxKey)))
         return GetResult::NOT_FOUND;
 
-    return getBinary(key, value);
+    return getBinary(key, value, snapshot, seq, bytesRead);
+}
+
+// =======================
+GetResult SSTable::get(const Slice& key,
+                       std::string& value,
+                       SequenceNumber snapshot) const {
+
+    PinnableSlice pinned;
+    GetResult res = get(key, pinned, snapshot);
+
+    if (res == GetResult::FOUND)
+        value.assign(pinned.data(), pinned.size());
+
+    return res;
 }
 
 // =======================
@@ -1,70 +1,102 @@
 #include "SSTableIterator.h"
 
+#include <cstring>
+#include <algorithm>
 
 
-SSTableIterator::SSTableIterator(const SSTable& t)
-    : table(t),
-      in(t.getFilePath(), std::ios::binary) {
+SSTableIterator::SSTableIterator(const SSTable& table,
+                                 RateLimiter* limiter,
+                                 IOPriority priority)
+    : tagged(table.hasSequenceNumbers()),
+      globalSeq(table.getGlobalSequence()),
+      index(table.getSparseIndex()),
+      in(table.getFilePath(), std::ios::binary),
+      rateLimiter(limiter),
+      ioPriority(priority) {
 
     if (!in.is_open()) {
         isValid = false;
         return;
     }
 
-    // Read footer
-    in.seekg(-static_cast<std::streamoff>(sizeof(uint64_t) * 2), std::ios::end);
+    // Data records end where the sparse index begins
+    dataEnd = table.getIndexOffset();
 
-    uint64_t indexOffset;
-    uint64_t magic;
+    buf.resize(READ_CHUNK);
 
-    in.read(reinterpret_cast<char*>(&indexOffset), sizeof(indexOffset));
-    in.read(reinterpret_cast<char*>(&magic), sizeof(magic));
+    loadNext();
+}
 
-    dataEnd = indexOffset;
 
-    // Reset to beginning
-    in.seekg(0);
+bool SSTableIterator::fill(size_t need){
 
-    loadNext();
+    if (bufEnd - bufPos >= need)
+        return true;
+
+    // Slide the unread tail to the front, reusing the buffer
+    std::memmove(buf.data(), buf.data() + bufPos, bufEnd - bufPos);
+    bufEnd -= bufPos;
+    bufPos = 0;
+
+    if (buf.size() < need)
+        buf.resize(std::max(need, buf.size() * 2));
+
+    uint64_t toRead = std::min<uint64_t>(buf.size() - bufEnd,
+                                         dataEnd - fileOffset);
+
+    if (toRead > 0) {
+        if (rateLimiter)
+            rateLimiter->request(toRead, ioPriority);
+
+        in.seekg(fileOffset);
+        in.read(buf.data() + bufEnd, toRead);
+
+        size_t got = static_cast<size_t>(in.gcount());
+        bufEnd += got;
+        fileOffset += got;
+    }
+
+    return bufEnd - bufPos >= need;
 }
 
 
 void SSTableIterator::loadNext(){
 
-    if(!in.good() || static_cast<uint64_t>(in.tellg()) >= dataEnd){
-        isValid = false;
-        return;
-    }
+    while (true) {
 
-    uint32_t k, v;
+        const char* p = buf.data() + bufPos;
 
-    if(!in.read(reinterpret_cast<char*>(&k), sizeof(k))){
-        isValid = false;
-        return;
-    }
+        if (SSTable::decodeRecord(p, buf.data() + bufEnd, tagged, cur, globalSeq)) {
+            bufPos = p - buf.data();
+            isValid = true;
+            return;
+        }
 
-    if(static_cast<uint64_t>(in.tellg()) + k > dataEnd){
-        isValid = false;
-        return;
+        // Partial record buffered: pull in more (growing if needed)
+        size_t buffered = bufEnd - bufPos;
+
+        if (fileOffset >= dataEnd || !fill(buffered + 1)) {
+            isValid = false;
+            return;
+        }
     }
+}
 
-    curKey.resize(k);
-    in.read(&curKey[0], k);
+void SSTableIterator::seek(const Slice& target){
 
-    if(!in.read(reinterpret_cast<char*>(&v), sizeof(v))){
-        isValid = false;
+    if (!in.is_open())
         return;
-    }
 
-    if(static_cast<uint64_t>(in.tellg()) + v > dataEnd){
-        isValid = false;
-        return;
-    }
+    // Restart the buffer at the block that may hold `target`
+    fileOffset = (index && !index->empty())
+                     ? (*index)[SSTable::findBlock(*index, target)].offset
+                     : 0;
+    bufPos = bufEnd = 0;
 
-    curValue.resize(v);
-    in.read(&curValue[0], v);
+    loadNext();
 
-    isValid = true;
+    while (isValid && cur.key < target)
+        loadNext();
 }
 
 bool SSTableIterator::valid() const {
@@ -75,10 +107,14 @@ void SSTableIterator::next() {
     loadNext();
 }
 
-const std::string& SSTableIterator::key() const {
-    return curKey;
+Slice SSTableIterator::key() const {
+    return cur.key;
+}
+
+Slice SSTableIterator::value() const {
+    return cur.value;
 }
 
-const std::string& SSTableIterator::value() const {
-    return curValue;
+SequenceNumber SSTableIterator::sequence() const {
+    return cur.sequence();
 }
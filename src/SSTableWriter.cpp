@@ -0,0 +1,68 @@
+#include "SSTableWriter.h"
+#include "MemTable.h"
+#include "Logger.h"
+
+#include <cstdio>
+
+SSTableWriter::SSTableWriter(const std::string& path,
+                             size_t bloomBits,
+                             size_t bloomHashes)
+    : table(path, bloomBits, bloomHashes) {
+
+    opened = table.beginBuild(build);
+    failed = !opened;
+}
+
+bool SSTableWriter::add(const Slice& key, const Slice& value) {
+
+    if (!opened || finished)
+        return false;
+
+    if (entries > 0 && !(Slice(lastKey) < key)) {
+        LOG_ERROR("SSTableWriter: key out of order in " + table.getFilePath());
+        failed = true;
+        return false;
+    }
+
+    table.addToBuild(build, key, 0, value);
+    lastKey.assign(key.data(), key.size());
+    ++entries;
+
+    return true;
+}
+
+bool SSTableWriter::put(const Slice& key, const Slice& value) {
+    return add(key, value);
+}
+
+bool SSTableWriter::remove(const Slice& key) {
+    return add(key, MemTable::TOMBSTONE);
+}
+
+bool SSTableWriter::finish() {
+
+    if (!opened || finished)
+        return false;
+
+    finished = true;
+
+    // A complete file must not exist for a writer that lost entries
+    if (failed) {
+        LOG_ERROR("SSTableWriter: rejected entries, file discarded: " +
+                  table.getFilePath());
+        abandon();
+        return false;
+    }
+
+    if (!table.finishBuild(build, nullptr)) {
+        abandon();
+        return false;
+    }
+
+    return true;
+}
+
+void SSTableWriter::abandon() {
+    build.out.close();
+    std::remove(table.getFilePath().c_str());
+}
@@ -0,0 +1,116 @@
+#include "SkipList.h"
+
+#include <new>
+
+SkipList::SkipList()
+    : head(newNode(Slice(), 0, Slice(), MAX_HEIGHT)) {
+}
+
+SkipList::~SkipList() {
+    clear();
+    deleteNode(head);
+}
+
+SkipList::Node* SkipList::newNode(const Slice& key, SequenceNumber seq,
+                                  const Slice& value, int height) {
+    void* mem = ::operator new(nodeSize(height));
+    Node* node = new (mem) Node(key, seq, value, height);
+
+    for (int i = 0; i < height; i++)
+        new (&node->links[i]) std::atomic<Node*>(nullptr);
+
+    return node;
+}
+
+void SkipList::deleteNode(Node* node) {
+    node->~Node();
+    ::operator delete(node);
+}
+
+int SkipList::randomHeight() {
+    // xorshift32; one level up with probability 1/4
+    int height = 1;
+    while (height < MAX_HEIGHT) {
+        rnd ^= rnd << 13;
+        rnd ^= rnd >> 17;
+        rnd ^= rnd << 5;
+        if (rnd % 4 != 0)
+            break;
+        height++;
+    }
+    return height;
+}
+
+SkipList::Node* SkipList::findGreaterOrEqual(const LookupKey& target, Node** prev) const {
+    Node* x = head;
+    int level = maxHeight.load(std::memory_order_relaxed) - 1;
+
+    while (true) {
+        Node* next = x->next(level);
+
+        if (next && InternalKeyComparator()(next->key, target)) {
+            x = next;
+            continue;
+        }
+
+        if (prev)
+            prev[level] = x;
+
+        if (level == 0)
+            return next;
+
+        level--;
+    }
+}
+
+const SkipList::Node* SkipList::lowerBound(const LookupKey& target) const {
+    return findGreaterOrEqual(target, nullptr);
+}
+
+const SkipList::Node* SkipList::insert(const Slice& key,
+                                       SequenceNumber seq,
+                                       const Slice& value) {
+    Node* prev[MAX_HEIGHT];
+    Node* x = findGreaterOrEqual(LookupKey{key, seq}, prev);
+
+    if (x && x->key.sequence == seq && Slice(x->key.userKey) == key)
+        return nullptr;
+
+    const int height = randomHeight();
+    const int current = maxHeight.load(std::memory_order_relaxed);
+
+    if (height > current) {
+        for (int i = current; i < height; i++)
+            prev[i] = head;
+
+        // A reader seeing the new height before the links only finds
+        // nullptr at the head there and drops a level
+        maxHeight.store(height, std::memory_order_relaxed);
+    }
+
+    Node* node = newNode(key, seq, value, height);
+
+    // Bottom up: once reachable on level i the node is complete below it
+    for (int i = 0; i < height; i++) {
+        node->links[i].store(prev[i]->next(i), std::memory_order_relaxed);
+        prev[i]->setNext(i, node);
+    }
+
+    count.fetch_add(1, std::memory_order_relaxed);
+    return node;
+}
+
+void SkipList::clear() {
+    Node* x = head->next(0);
+    while (x) {
+        Node* next = x->next(0);
+        deleteNode(x);
+        x = next;
+    }
+
+    for (int i = 0; i < MAX_HEIGHT; i++)
+        head->setNext(i, nullptr);
+
+    maxHeight.store(1, std::memory_order_relaxed);
+    count.store(0, std::memory_order_relaxed);
+}
@@ -0,0 +1,351 @@
+#include "Statistics.h"
+
+#include <cstring>
+#include <fstream>
+#include <sstream>
+#include <iterator>
+#include <vector>
+
+// "AKST" + format version
+static constexpr uint32_t STATS_MAGIC = 0x54534B41;
+static constexpr uint32_t STATS_FORMAT_VERSION = 1;
+
+// =======================
+// NAMES (stable: used as serialization keys)
+// =======================
+const char* Statistics::tickerName(Ticker ticker) {
+    switch (ticker) {
+        case Ticker::PUTS:                     return "aurora.puts";
+        case Ticker::GETS:                     return "aurora.gets";
+        case Ticker::DELETES:                  return "aurora.deletes";
+        case Ticker::RANGE_DELETES:            return "aurora.range.deletes";
+        case Ticker::BYTES_WRITTEN:            return "aurora.bytes.written";
+        case Ticker::FLUSHES:                  return "aurora.flushes";
+        case Ticker::FLUSH_BYTES:              return "aurora.flush.bytes";
+        case Ticker::COMPACTIONS:              return "aurora.compactions";
+        case Ticker::COMPACTION_BYTES_READ:    return "aurora.compaction.bytes.read";
+        case Ticker::COMPACTION_BYTES_WRITTEN: return "aurora.compaction.bytes.written";
+        case Ticker::SUBCOMPACTIONS:           return "aurora.compaction.subcompactions";
+        case Ticker::TRIVIAL_MOVES:            return "aurora.compaction.trivial.moves";
+        case Ticker::TRIVIAL_MOVE_BYTES:       return "aurora.compaction.trivial.move.bytes";
+        case Ticker::TOMBSTONE_COMPACTIONS:    return "aurora.compaction.tombstone.triggered";
+        case Ticker::INGESTED_FILES:           return "aurora.ingest.files";
+        case Ticker::INGESTED_BYTES:           return "aurora.ingest.bytes";
+        case Ticker::WRITE_BUFFER_MANAGER_FLUSHES: return "aurora.write.buffer.manager.flushes";
+        case Ticker::SSTABLES_READ:            return "aurora.sstables.read";
+        case Ticker::BLOOM_CHECKS:             return "aurora.bloom.checks";
+        case Ticker::BLOOM_NEGATIVES:          return "aurora.bloom.negatives";
+        case Ticker::BLOOM_FALSE_POSITIVES:    return "aurora.bloom.false.positives";
+        case Ticker::CACHE_HITS:               return "aurora.cache.hits";
+        case Ticker::CACHE_MISSES:             return "aurora.cache.misses";
+        case Ticker::STALLED_WRITES:           return "aurora.stall.writes";
+        case Ticker::STALL_SLOWDOWN_NANOS:     return "aurora.stall.slowdown.nanos";
+        case Ticker::STALL_STOP_NANOS:         return "aurora.stall.stop.nanos";
+        case Ticker::STALL_L0_FILES_NANOS:     return "aurora.stall.l0.files.nanos";
+        case Ticker::STALL_MEMTABLES_NANOS:    return "aurora.stall.memtables.nanos";
+        case Ticker::STALL_PENDING_COMPACTION_NANOS:
+                                               return "aurora.stall.pending.compaction.nanos";
+        default:                               return "aurora.unknown";
+    }
+}
+
+const char* Statistics::histogramName(HistogramType type) {
+    switch (type) {
+        case HistogramType::GET_LATENCY:        return "aurora.get.nanos";
+        case HistogramType::PUT_LATENCY:        return "aurora.put.nanos";
+        case HistogramType::FLUSH_LATENCY:      return "aurora.flush.nanos";
+        case HistogramType::COMPACTION_LATENCY: return "aurora.compaction.nanos";
+        case HistogramType::FLUSH_BYTES:        return "aurora.flush.bytes";
+        case HistogramType::COMPACTION_BYTES:   return "aurora.compaction.bytes";
+        default:                                return "aurora.unknown";
+    }
+}
+
+const char* Statistics::levelCounterName(LevelCounter counter) {
+    switch (counter) {
+        case LevelCounter::FLUSH_BYTES:           return "flush.bytes";
+        case LevelCounter::COMPACTION_READ_UPPER: return "compaction.read.upper.bytes";
+        case LevelCounter::COMPACTION_READ_LOWER: return "compaction.read.lower.bytes";
+        case LevelCounter::COMPACTION_WRITTEN:    return "compaction.written.bytes";
+        case LevelCounter::COMPACTIONS:           return "compactions";
+        case LevelCounter::COMPACTION_NANOS:      return "compaction.nanos";
+        case LevelCounter::TRIVIAL_MOVE_BYTES:    return "trivial.move.bytes";
+        case LevelCounter::GET_TABLES_READ:       return "get.tables.read";
+        case LevelCounter::GET_BYTES_READ:        return "get.bytes.read";
+        default:                                  return "unknown";
+    }
+}
+
+// Serialized name of a per-level counter, e.g. "aurora.l1.compactions"
+static std::string levelCounterKey(size_t level, LevelCounter counter) {
+    return "aurora.l" + std::to_string(level) + "." +
+           Statistics::levelCounterName(counter);
+}
+
+// =======================
+// COUNTERS
+// =======================
+Statistics::Statistics() {
+    reset();
+}
+
+size_t Statistics::shardIndex() {
+    static std::atomic<size_t> nextShard(0);
+    thread_local const size_t shard =
+        nextShard.fetch_add(1, std::memory_order_relaxed) % SHARDS;
+    return shard;
+}
+
+uint64_t Statistics::getTickerCount(Ticker ticker) const {
+
+    uint64_t total = 0;
+    for (const auto& shard : shards)
+        total += shard.tickers[static_cast<size_t>(ticker)]
+                     .load(std::memory_order_relaxed);
+    return total;
+}
+
+uint64_t Statistics::getLevelCount(size_t level, LevelCounter counter) const {
+
+    if (level >= MAX_TRACKED_LEVELS)
+        return 0;
+
+    uint64_t total = 0;
+    for (const auto& shard : shards)
+        total += shard.levels[level][static_cast<size_t>(counter)]
+                     .load(std::memory_order_relaxed);
+    return total;
+}
+
+HistogramSnapshot Statistics::getHistogram(HistogramType type) const {
+    return histograms[static_cast<size_t>(type)].snapshot();
+}
+
+void Statistics::reset() {
+
+    for (auto& shard : shards)
+        for (auto& t : shard.tickers)
+            t.store(0, std::memory_order_relaxed);
+
+    for (auto& shard : shards)
+        for (auto& level : shard.levels)
+            for (auto& c : level)
+                c.store(0, std::memory_order_relaxed);
+
+    for (auto& h : histograms)
+        h.reset();
+}
+
+// =======================
+// SERIALIZATION
+//
+// [u32 magic][u32 version]
+// [u32 n]{[u16 nameLen][name][u64 value]}                    tickers and
+//                                                            non-zero level counters
+// [u32 n]{[u16 nameLen][name][u64 count][u64 sum][u64 min]
+//         [u64 max][u32 buckets]{[u32 index][u64 count]}}    histograms
+// =======================
+static void putU16(std::string& out, uint16_t v) {
+    out.append(reinterpret_cast<const char*>(&v), sizeof(v));
+}
+
+static void putU32(std::string& out, uint32_t v) {
+    out.append(reinterpret_cast<const char*>(&v), sizeof(v));
+}
+
+static void putU64(std::string& out, uint64_t v) {
+    out.append(reinterpret_cast<const char*>(&v), sizeof(v));
+}
+
+static void putName(std::string& out, const std::string& name) {
+    putU16(out, static_cast<uint16_t>(name.size()));
+    out.append(name);
+}
+
+std::string Statistics::serialize() const {
+
+    std::string out;
+
+    putU32(out, STATS_MAGIC);
+    putU32(out, STATS_FORMAT_VERSION);
+
+    std::vector<std::pair<std::string, uint64_t>> counters;
+
+    for (size_t i = 0; i < TICKER_COUNT; i++)
+        counters.emplace_back(tickerName(static_cast<Ticker>(i)),
+                              getTickerCount(static_cast<Ticker>(i)));
+
+    for (size_t level = 0; level < MAX_TRACKED_LEVELS; level++) {
+        for (size_t c = 0; c < LEVEL_COUNTER_COUNT; c++) {
+            const uint64_t v = getLevelCount(level, static_cast<LevelCounter>(c));
+            if (v)
+                counters.emplace_back(levelCounterKey(level, static_cast<LevelCounter>(c)), v);
+        }
+    }
+
+    putU32(out, static_cast<uint32_t>(counters.size()));
+    for (const auto& [name, value] : counters) {
+        putName(out, name);
+        putU64(out, value);
+    }
+
+    putU32(out, static_cast<uint32_t>(HISTOGRAM_COUNT));
+    for (size_t i = 0; i < HISTOGRAM_COUNT; i++) {
+
+        const HistogramSnapshot h = histograms[i].snapshot();
+
+        putName(out, histogramName(static_cast<HistogramType>(i)));
+        putU64(out, h.count);
+        putU64(out, h.sum);
+        putU64(out, h.min);
+        putU64(out, h.max);
+
+        uint32_t used = 0;
+        for (uint64_t c : h.counts)
+            if (c) used++;
+
+        putU32(out, used);
+        for (size_t b = 0; b < h.counts.size(); b++) {
+            if (!h.counts[b]) continue;
+            putU32(out, static_cast<uint32_t>(b));
+            putU64(out, h.counts[b]);
+        }
+    }
+
+    return out;
+}
+
+bool Statistics::deserialize(const std::string& data) {
+
+    const char* p = data.data();
+    const char* limit = p + data.size();
+
+    auto get = [&](auto& v) {
+        if (limit - p < static_cast<std::ptrdiff_t>(sizeof(v))) return false;
+        std::memcpy(&v, p, sizeof(v));
+        p += sizeof(v);
+        return true;
+    };
+
+    auto getName = [&](std::string& name) {
+        uint16_t n;
+        if (!get(n) || limit - p < n) return false;
+        name.assign(p, n);
+        p += n;
+        return true;
+    };
+
+    uint32_t magic, version;
+    if (!get(magic) || magic != STATS_MAGIC ||
+        !get(version) || version == 0 || version > STATS_FORMAT_VERSION)
+        return false;
+
+    // Decode everything first so a truncated file applies nothing
+    uint64_t tickers[TICKER_COUNT] = {};
+    uint64_t levels[MAX_TRACKED_LEVELS][LEVEL_COUNTER_COUNT] = {};
+    HistogramSnapshot hists[HISTOGRAM_COUNT];
+
+    uint32_t n;
+    if (!get(n)) return false;
+
+    for (uint32_t i = 0; i < n; i++) {
+        std::string name;
+        uint64_t value;
+        if (!getName(name) || !get(value)) return false;
+
+        for (size_t t = 0; t < TICKER_COUNT; t++)
+            if (name == tickerName(static_cast<Ticker>(t)))
+                tickers[t] = value;
+
+        if (name.rfind("aurora.l", 0) == 0) {
+            for (size_t level = 0; level < MAX_TRACKED_LEVELS; level++)
+                for (size_t c = 0; c < LEVEL_COUNTER_COUNT; c++)
+                    if (name == levelCounterKey(level, static_cast<LevelCounter>(c)))
+                        levels[level][c] = value;
+        }
+    }
+
+    if (!get(n)) return false;
+
+    for (uint32_t i = 0; i < n; i++) {
+        std::string name;
+        HistogramSnapshot h;
+        uint32_t used;
+
+        if (!getName(name) || !get(h.count) || !get(h.sum) ||
+            !get(h.min) || !get(h.max) || !get(used))
+            return false;
+
+        h.counts.resize(Histogram::BUCKETS);
+
+        for (uint32_t b = 0; b < used; b++) {
+            uint32_t index;
+            uint64_t count;
+            if (!get(index) || !get(count)) return false;
+            if (index < Histogram::BUCKETS) h.counts[index] = count;
+        }
+
+        for (size_t t = 0; t < HISTOGRAM_COUNT; t++)
+            if (name == histogramName(static_cast<HistogramType>(t)))
+                hists[t] = std::move(h);
+    }
+
+    for (size_t t = 0; t < TICKER_COUNT; t++)
+        if (tickers[t])
+            recordTick(static_cast<Ticker>(t), tickers[t]);
+
+    for (size_t level = 0; level < MAX_TRACKED_LEVELS; level++)
+        for (size_t c = 0; c < LEVEL_COUNTER_COUNT; c++)
+            if (levels[level][c])
+                recordLevel(level, static_cast<LevelCounter>(c), levels[level][c]);
+
+    for (size_t t = 0; t < HISTOGRAM_COUNT; t++)
+        histograms[t].add(hists[t]);
+
+    return true;
+}
+
+bool Statistics::saveTo(const std::string& path) const {
+
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    if (!out.is_open())
+        return false;
+
+    const std::string data = serialize();
+    out.write(data.data(), data.size());
+    return static_cast<bool>(out);
+}
+
+bool Statistics::loadFrom(const std::string& path) {
+
+    std::ifstream in(path, std::ios::binary);
+    if (!in.is_open())
+        return false;
+
+    std::string data((std::istreambuf_iterator<char>(in)),
+                     std::istreambuf_iterator<char>());
+
+    return deserialize(data);
+}
+
+std::string Statistics::toString() const {
+
+    std::ostringstream out;
+
+    for (size_t i = 0; i < TICKER_COUNT; i++)
+        out << tickerName(static_cast<Ticker>(i)) << " : "
+            << getTickerCount(static_cast<Ticker>(i)) << "\n";
+
+    for (size_t i = 0; i < HISTOGRAM_COUNT; i++) {
+        const HistogramSnapshot h = histograms[i].snapshot();
+        out << histogramName(static_cast<HistogramType>(i))
+            << " : count " << h.count
+            << " mean " << h.mean()
+            << " p50 " << h.percentile(50)
+            << " p99 " << h.percentile(99)
+            << " p99.9 " << h.percentile(99.9)
+            << " max " << h.max << "\n";
+    }
+
+    return out.str();
+}
@@ -0,0 +1,101 @@
+#include "ThreadPool.h"
+
+#include <algorithm>
+
+ThreadPool::ThreadPool(const std::string& name, size_t threads)
+    : name(name),
+      started(Clock::now()),
+      runningSince(std::max<size_t>(threads, 1)) {
+
+    for (size_t i = 0; i < runningSince.size(); i++)
+        workers.emplace_back(&ThreadPool::workerLoop, this, i);
+}
+
+ThreadPool::~ThreadPool() {
+    shutdown();
+}
+
+void ThreadPool::schedule(std::function<void()> job, double score) {
+    {
+        std::lock_guard<std::mutex> lock(mtx);
+
+        if (stopping)
+            return;
+
+        queue.push(Job{score, nextOrder++, std::move(job)});
+    }
+
+    ready.notify_one();
+}
+
+void ThreadPool::shutdown() {
+    {
+        std::lock_guard<std::mutex> lock(mtx);
+
+        if (stopping)
+            return;
+
+        stopping = true;
+        queue = std::priority_queue<Job>();
+    }
+
+    ready.notify_all();
+
+    for (auto& worker : workers)
+        if (worker.joinable())
+            worker.join();
+}
+
+ThreadPoolStats ThreadPool::getStats() const {
+
+    std::lock_guard<std::mutex> lock(mtx);
+
+    const Clock::time_point now = Clock::now();
+
+    ThreadPoolStats s;
+    s.threads = workers.size();
+    s.queued = queue.size();
+    s.active = active;
+    s.completed = completed;
+
+    // Count the part of running jobs that has elapsed so far
+    uint64_t busy = busyNanos;
+    for (const Clock::time_point& since : runningSince)
+        if (since != Clock::time_point())
+            busy += std::chrono::duration_cast<std::chrono::nanoseconds>(now - since).count();
+
+    const double available =
+        std::chrono::duration<double, std::nano>(now - started).count() * s.threads;
+
+    s.utilization = available > 0 ? std::min(1.0, busy / available) : 0.0;
+    return s;
+}
+
+void ThreadPool::workerLoop(size_t slot) {
+
+    while (true) {
+        Job job;
+        {
+            std::unique_lock<std::mutex> lock(mtx);
+            ready.wait(lock, [this] { return stopping || !queue.empty(); });
+
+            if (stopping)
+                return;
+
+            job = queue.top();
+            queue.pop();
+
+            ++active;
+            runningSince[slot] = Clock::now();
+        }
+
+        job.run();
+
+        std::lock_guard<std::mutex> lock(mtx);
+        busyNanos += std::chrono::duration_cast<std::chrono::nanoseconds>(
+            Clock::now() - runningSince[slot]).count();
+        runningSince[slot] = Clock::time_point();
+        --active;
+        ++completed;
+    }
+}
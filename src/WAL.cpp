@@ -6,10 +6,15 @@
 #include <filesystem>
 #include <cstring>
 #include <mutex>
+#include <algorithm>
+#include <cctype>
 
 enum OpCode : uint8_t {
-    PUT = 1,
-    DEL = 2
+    PUT = 1,        // legacy, no sequence number
+    DEL = 2,        // legacy, no sequence number
+    PUT_SEQ = 3,
+    DEL_SEQ = 4,
+    DEL_RANGE = 5   // key = range start, value = range end
 };
 
 WAL::WAL(const std::string& path, size_t batchSize)
@@ -19,24 +24,98 @@ WAL::WAL(const std::string& path, size_t batchSize)
         std::filesystem::path(path).parent_path()
     );
 
+    for (const std::string& sealed : sealedLogs())
+        nextLogNumber = std::max<uint64_t>(
+            nextLogNumber,
+            sealedNumber(std::filesystem::path(sealed).filename().string()) + 1);
+
     LOG_INFO("WAL initialized at path: " + path);
 }
 
+long long WAL::sealedNumber(const std::string& fileName) const {
+
+    const std::string prefix = std::filesystem::path(path).filename().string() + ".";
+
+    if (fileName.size() <= prefix.size() ||
+        fileName.compare(0, prefix.size(), prefix) != 0)
+        return -1;
+
+    const std::string suffix = fileName.substr(prefix.size());
+    if (!std::all_of(suffix.begin(), suffix.end(),
+                     [](unsigned char ch) { return std::isdigit(ch) != 0; }))
+        return -1;
+
+    return std::stoll(suffix);
+}
+
+std::vector<std::string> WAL::sealedLogs() const {
+
+    const std::filesystem::path dir = std::filesystem::path(path).parent_path();
+
+    std::vector<std::pair<long long, std::string>> found;
+
+    std::error_code ec;
+    for (const auto& entry : std::filesystem::directory_iterator(
+             dir.empty() ? std::filesystem::path(".") : dir, ec)) {
+
+        const std::string name = entry.path().filename().string();
+        const long long n = sealedNumber(name);
+
+        if (n >= 0)
+            found.emplace_back(n, (dir / name).string());
+    }
+
+    std::sort(found.begin(), found.end());
+
+    std::vector<std::string> logs;
+    for (auto& f : found)
+        logs.push_back(std::move(f.second));
+    return logs;
+}
+
+std::string WAL::rotate() {
+    std::lock_guard<std::mutex> lock(mtx);
+
+    flushUnlocked();
+
+    if (!std::filesystem::exists(path))
+        return "";
+
+    const std::string sealed = path + "." + std::to_string(nextLogNumber++);
+
+    std::error_code ec;
+    std::filesystem::rename(path, sealed, ec);
+
+    if (ec) {
+        LOG_ERROR("WAL rotate failed: " + ec.message());
+        return "";
+    }
+
+    return sealed;
+}
+
 void WAL::appendUInt32(uint32_t v) {
     for (int i = 0; i < 4; ++i) {
         buffer.push_back(static_cast<char>((v >> (i * 8)) & 0xFF));
     }
 }
 
-void WAL::logPut(const std::string& key, const std::string& value) {
+void WAL::appendUInt64(uint64_t v) {
+    for (int i = 0; i < 8; ++i) {
+        buffer.push_back(static_cast<char>((v >> (i * 8)) & 0xFF));
+    }
+}
+
+void WAL::logPut(const Slice& key, const Slice& value, SequenceNumber seq) {
     std::lock_guard<std::mutex> lock(mtx);
 
-    buffer.push_back(static_cast<char>(PUT));
+    buffer.push_back(static_cast<char>(PUT_SEQ));
     appendUInt32(static_cast<uint32_t>(key.size()));
     appendUInt32(static_cast<uint32_t>(value.size()));
+    appendUInt64(seq);
 
-    buffer.insert(buffer.end(), key.begin(), key.end());
-    buffer.insert(buffer.end(), value.begin(), value.end());
+    buffer.insert(buffer.end(), key.data(), key.data() + key.size());
+    buffer.insert(buffer.end(), value.data(), value.data() + value.size());
 
     if (buffer.size() >= batchSize * 64) {
         LOG_DEBUG("WAL batch threshold reached, flushing");
@@ -44,14 +123,15 @@ void WAL::logPut(const std::string& key, const std::string& value) {
     }
 }
 
-void WAL::logDelete(const std::string& key) {
+void WAL::logDelete(const Slice& key, SequenceNumber seq) {
     std::lock_guard<std::mutex> lock(mtx);
 
-    buffer.push_back(static_cast<char>(DEL));
+    buffer.push_back(static_cast<char>(DEL_SEQ));
     appendUInt32(static_cast<uint32_t>(key.size()));
     appendUInt32(0);
+    appendUInt64(seq);
 
-    buffer.insert(buffer.end(), key.begin(), key.end());
+    buffer.insert(buffer.end(), key.data(), key.data() + key.size());
 
     if (buffer.size() >= batchSize * 64) {
         LOG_DEBUG("WAL batch threshold reached, flushing");
@@ -59,6 +139,23 @@ void WAL::logDelete(const std::string& key) {
     }
 }
 
+void WAL::logDeleteRange(const Slice& start, const Slice& end, SequenceNumber seq) {
+    std::lock_guard<std::mutex> lock(mtx);
+
+    buffer.push_back(static_cast<char>(DEL_RANGE));
+    appendUInt32(static_cast<uint32_t>(start.size()));
+    appendUInt32(static_cast<uint32_t>(end.size()));
+    appendUInt64(seq);
+
+    buffer.insert(buffer.end(), start.data(), start.data() + start.size());
+    buffer.insert(buffer.end(), end.data(), end.data() + end.size());
+
+    if (buffer.size() >= batchSize * 64) {
+        LOG_DEBUG("WAL batch threshold reached, flushing");
+        flushUnlocked();
+    }
+}
+
 void WAL::flushUnlocked() {
     if (buffer.empty())
         return;
@@ -88,15 +185,26 @@ void WAL::flush() {
     flushUnlocked();
 }
 
-void WAL::replay(MemTable& memTable) {
-    std::ifstream in(path, std::ios::binary);
+void WAL::replay(MemTable& memTable, SequenceNumber& lastSequence) {
+
+    for (const std::string& sealed : sealedLogs())
+        replayFile(sealed, memTable, lastSequence);
+
+    replayFile(path, memTable, lastSequence);
+}
+
+void WAL::replayFile(const std::string& file,
+                     MemTable& memTable,
+                     SequenceNumber& lastSequence) {
+
+    std::ifstream in(file, std::ios::binary);
 
     if (!in.is_open()) {
         LOG_DEBUG("WAL replay skipped: file not found");
         return;
     }
 
-    LOG_INFO("WAL replay started");
+    LOG_INFO("WAL replay started: " + file);
 
     size_t replayedOps = 0;
 
@@ -110,21 +218,38 @@ void WAL::replay(MemTable& memTable) {
         in.read(reinterpret_cast<char*>(&keyLen), 4);
         in.read(reinterpret_cast<char*>(&valLen), 4);
 
+        SequenceNumber seq = 0;
+        const bool sequenced = (op == PUT_SEQ || op == DEL_SEQ || op == DEL_RANGE);
+
+        if (sequenced)
+            in.read(reinterpret_cast<char*>(&seq), 8);
+
         if (!in.good()) {
             LOG_ERROR("WAL replay aborted: corrupted header");
             break;
         }
 
+        if (sequenced) {
+            if (seq > lastSequence) lastSequence = seq;
+        } else {
+            seq = ++lastSequence;
+        }
+
         std::string key(keyLen, '\0');
         in.read(&key[0], keyLen);
 
-        if (op == PUT) {
+        if (op == PUT || op == PUT_SEQ) {
             std::string value(valLen, '\0');
             in.read(&value[0], valLen);
-            memTable.put(key, value);
+            memTable.put(key, value, seq);
+        }
+        else if (op == DEL || op == DEL_SEQ) {
+            memTable.remove(key, seq);
         }
-        else if (op == DEL) {
-            memTable.put(key, MemTable::TOMBSTONE);
+        else if (op == DEL_RANGE) {
+            std::string end(valLen, '\0');
+            in.read(&end[0], valLen);
+            memTable.addRangeTombstone(key, end, seq);
         }
 
         replayedOps++;
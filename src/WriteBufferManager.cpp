@@ -0,0 +1,83 @@
+#include "WriteBufferManager.h"
+#include "Logger.h"
+
+#include <algorithm>
+#include <string>
+
+WriteBufferManager& WriteBufferManager::global() {
+    static WriteBufferManager manager;
+    return manager;
+}
+
+void WriteBufferManager::setBufferSize(size_t bytes) {
+    bufferSize = bytes;
+    LOG_INFO("Write buffer manager budget: " + std::to_string(bytes) + " bytes");
+}
+
+void WriteBufferManager::reserveMem(size_t bytes) {
+    memoryUsed += bytes;
+    mutableUsed += bytes;
+}
+
+void WriteBufferManager::scheduleFreeMem(size_t bytes) {
+    mutableUsed -= bytes;
+}
+
+void WriteBufferManager::freeMem(size_t bytes) {
+    memoryUsed -= bytes;
+}
+
+bool WriteBufferManager::shouldFlush() const {
+
+    const size_t budget = bufferSize.load();
+    if (budget == 0)
+        return false;
+
+    const size_t mutableBytes = mutableUsed.load();
+
+    if (mutableBytes > budget - budget / 8)
+        return true;
+
+    return memoryUsed.load() >= budget && mutableBytes >= budget / 2;
+}
+
+void WriteBufferManager::maybeFlush() {
+
+    if (!shouldFlush())
+        return;
+
+    std::lock_guard<std::mutex> lock(mtx);
+
+    // Another writer may have flushed while this one waited
+    if (!shouldFlush())
+        return;
+
+    WriteBufferClient* largest = nullptr;
+    size_t largestBytes = 0;
+
+    for (WriteBufferClient* client : clients) {
+        const size_t bytes = client->activeMemTableBytes();
+        if (bytes > largestBytes) {
+            largest = client;
+            largestBytes = bytes;
+        }
+    }
+
+    if (!largest)
+        return;
+
+    LOG_DEBUG("Write buffer manager: flushing a " + std::to_string(largestBytes) +
+              " byte MemTable (" + std::to_string(memoryUsed.load()) + " bytes in use)");
+
+    largest->requestFlush();
+}
+
+void WriteBufferManager::registerClient(WriteBufferClient* client) {
+    std::lock_guard<std::mutex> lock(mtx);
+    clients.push_back(client);
+}
+
+void WriteBufferManager::unregisterClient(WriteBufferClient* client) {
+    std::lock_guard<std::mutex> lock(mtx);
+    clients.erase(std::remove(clients.begin(), clients.end(), client), clients.end());
+}
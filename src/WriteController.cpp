@@ -0,0 +1,189 @@
+#include "WriteController.h"
+
+#include <thread>
+#include <algorithm>
+
+// Burst allowance: writes may run this far ahead of the rate
+static constexpr double MAX_CREDIT_SECONDS = 0.001;
+
+// The delayed rate never drops below this fraction of the initial rate
+static constexpr uint64_t MIN_RATE_DIVISOR = 16;
+
+WriteController::WriteController(const WriteControllerOptions& options)
+    : options(options),
+      lastRefill(Clock::now()) {}
+
+const char* WriteController::causeName(StallCause cause) {
+    switch (cause) {
+        case StallCause::L0_FILES:                 return "L0 files";
+        case StallCause::IMMUTABLE_MEMTABLES:      return "immutable memtables";
+        case StallCause::PENDING_COMPACTION_BYTES: return "pending compaction bytes";
+        default:                                   return "none";
+    }
+}
+
+// =======================
+// STATE
+// =======================
+void WriteController::setOptions(const WriteControllerOptions& options) {
+    std::lock_guard<std::mutex> lock(mtx);
+    this->options = options;
+}
+
+void WriteController::update(int l0Files,
+                             int immutableMemTables,
+                             uint64_t pendingCompactionBytes) {
+
+    // How far past its slowdown trigger a signal is: <0 below the
+    // trigger, 0..1 on the way to its stop trigger, >=1 stopped
+    auto pressure = [](double value, double slowdown, double stop) {
+        if (value < slowdown) return -1.0;
+        if (value >= stop || stop <= slowdown) return 1.0;
+        return (value - slowdown) / (stop - slowdown);
+    };
+
+    struct Signal { StallCause cause; double pressure; };
+
+    std::lock_guard<std::mutex> lock(mtx);
+
+    const Signal signals[] = {
+        {StallCause::L0_FILES,
+         pressure(l0Files, options.l0SlowdownTrigger, options.l0StopTrigger)},
+        {StallCause::IMMUTABLE_MEMTABLES,
+         pressure(immutableMemTables, options.immutableSlowdownTrigger,
+                  options.immutableStopTrigger)},
+        {StallCause::PENDING_COMPACTION_BYTES,
+         pressure(static_cast<double>(pendingCompactionBytes),
+                  static_cast<double>(options.pendingCompactionSlowdownBytes),
+                  static_cast<double>(options.pendingCompactionStopBytes))}
+    };
+
+    const Signal worst = *std::max_element(
+        std::begin(signals), std::end(signals),
+        [](const Signal& a, const Signal& b) { return a.pressure < b.pressure; });
+
+    const WriteCondition previous = condition;
+
+    if (worst.pressure >= 1.0) {
+        condition = WriteCondition::STOPPED;
+        cause = worst.cause;
+    } else if (worst.pressure >= 0.0) {
+        condition = WriteCondition::DELAYED;
+        cause = worst.cause;
+
+        const uint64_t floor = std::max<uint64_t>(options.delayedWriteRate / MIN_RATE_DIVISOR, 1);
+        rate = std::max(floor, static_cast<uint64_t>(
+                                   options.delayedWriteRate * (1.0 - worst.pressure)));
+
+        if (previous != WriteCondition::DELAYED) {
+            credit = 0;
+            lastRefill = Clock::now();
+        }
+    } else {
+        condition = WriteCondition::NORMAL;
+        cause = StallCause::NONE;
+        rate = 0;
+    }
+
+    if (condition != WriteCondition::STOPPED)
+        writable.notify_all();
+}
+
+void WriteController::shutdown() {
+    std::lock_guard<std::mutex> lock(mtx);
+    stopping = true;
+    writable.notify_all();
+}
+
+WriteCondition WriteController::getCondition() const {
+    std::lock_guard<std::mutex> lock(mtx);
+    return condition;
+}
+
+StallCause WriteController::getCause() const {
+    std::lock_guard<std::mutex> lock(mtx);
+    return cause;
+}
+
+uint64_t WriteController::getDelayedWriteRate() const {
+    std::lock_guard<std::mutex> lock(mtx);
+    return condition == WriteCondition::DELAYED ? rate : 0;
+}
+
+// =======================
+// WRITER SIDE
+// =======================
+std::chrono::nanoseconds WriteController::takeTokens(uint64_t bytes) {
+
+    const Clock::time_point now = Clock::now();
+    const double elapsed = std::chrono::duration<double>(now - lastRefill).count();
+    lastRefill = now;
+
+    credit = std::min(credit + elapsed * rate, rate * MAX_CREDIT_SECONDS);
+    credit -= static_cast<double>(bytes);
+
+    if (credit >= 0)
+        return std::chrono::nanoseconds(0);
+
+    // Writers queue behind each other's debt
+    return std::chrono::nanoseconds(static_cast<int64_t>(-credit / rate * 1e9));
+}
+
+void WriteController::delayWrite(uint64_t bytes, Statistics& stats) {
+
+    std::unique_lock<std::mutex> lock(mtx);
+
+    if (condition == WriteCondition::NORMAL || stopping)
+        return;
+
+    if (condition == WriteCondition::STOPPED) {
+
+        const StallCause stalledBy = cause;
+        const Clock::time_point start = Clock::now();
+
+        writable.wait(lock, [this] {
+            return condition != WriteCondition::STOPPED || stopping;
+        });
+
+        recordStall(stats, stalledBy, true,
+                    std::chrono::duration_cast<std::chrono::nanoseconds>(
+                        Clock::now() - start).count());
+
+        if (condition != WriteCondition::DELAYED || stopping)
+            return;
+    }
+
+    const StallCause stalledBy = cause;
+    const std::chrono::nanoseconds delay = takeTokens(bytes);
+
+    lock.unlock();
+
+    if (delay.count() > 0) {
+        std::this_thread::sleep_for(delay);
+        recordStall(stats, stalledBy, false, delay.count());
+    }
+}
+
+void WriteController::recordStall(Statistics& stats,
+                                  StallCause cause,
+                                  bool stopped,
+                                  uint64_t nanos) {
+
+    stats.recordTick(Ticker::STALLED_WRITES);
+    stats.recordTick(stopped ? Ticker::STALL_STOP_NANOS
+                             : Ticker::STALL_SLOWDOWN_NANOS, nanos);
+
+    switch (cause) {
+        case StallCause::L0_FILES:
+            stats.recordTick(Ticker::STALL_L0_FILES_NANOS, nanos);
+            break;
+        case StallCause::IMMUTABLE_MEMTABLES:
+            stats.recordTick(Ticker::STALL_MEMTABLES_NANOS, nanos);
+            break;
+        case StallCause::PENDING_COMPACTION_BYTES:
+            stats.recordTick(Ticker::STALL_PENDING_COMPACTION_NANOS, nanos);
+            break;
+        default:
+            break;
+    }
+}
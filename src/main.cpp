@@ -6,6 +6,7 @@
 #include <chrono>
 
 #include "Logger.h"
+#include "BenchmarkRunner.h"
 
 // Load compaction strategy
 static std::string loadStrategy() {
@@ -93,6 +94,24 @@ int main(int argc, char* argv[]) {
                             std::cout << "NOT FOUND\n";
                     }
 
+                    // ------------------
+                    // GET WITH PERF CONTEXT
+                    // ------------------
+                    else if (cmd == "perfget") {
+                        std::string k, val;
+                        ss >> k;
+
+                        ReadOptions options;
+                        options.perfLevel = PerfLevel::TIME;
+
+                        if (store.get(options, k, val))
+                            std::cout << val << "\n";
+                        else
+                            std::cout << "NOT FOUND\n";
+
+                        std::cout << getPerfContext().toString() << "\n";
+                    }
+
                     // ------------------
                     // DELETE
                     // ------------------
@@ -104,6 +123,22 @@ int main(int argc, char* argv[]) {
                         std::cout << "DELETED\n";
                     }
 
+                    // ------------------
+                    // DELETE RANGE [start, end)
+                    // ------------------
+                    else if (cmd == "delrange") {
+                        std::string start, end;
+                        ss >> start >> end;
+
+                        if (start.empty() || end.empty()) {
+                            std::cout << "Usage: delrange <start> <end>\n";
+                            continue;
+                        }
+
+                        store.deleteRange(start, end);
+                        std::cout << "DELETED\n";
+                    }
+
                     // ------------------
                     // FLUSH
                     // ------------------
@@ -139,47 +174,42 @@ int main(int argc, char* argv[]) {
                     // ------------------
                     else if (cmd == "bench") {
 
-                        int n;
+                        int n = 0;
+                        RunnerOptions options;
+                        options.report_interval_sec = 0;
+
                         ss >> n;
+                        ss >> options.threads >> options.target_ops_per_sec;
 
                         if (n <= 0) {
-                            std::cout << "Usage: bench <operations>\n";
+                            std::cout << "Usage: bench <operations> [threads] [ops/sec]\n";
                             continue;
                         }
 
-                        auto start = std::chrono::steady_clock::now();
+                        // PUT phase: key_0 .. key_{n-1}
+                        BenchmarkConfig config;
+                        config.total_ops = n;
+                        config.key_space = n;
+                        config.key_dist = KeyDistribution::SEQUENTIAL;
+                        config.put_ratio = 1.0;
+                        config.get_ratio = config.delete_ratio = 0.0;
 
-                        // PUT phase (controlled)
-                        for (int i = 0; i < n; i++) {
-
-                            store.put("k" + std::to_string(i),
-                                      "v" + std::to_string(i));
-
-                            // Prevent excessive flush/compaction
-                            // if (i % 500 == 0) {
-                            //     store.flush();
-                            // }
-                        }
+                        RunResult writes = BenchmarkRunner(store, config, options).run();
 
                         store.flush(); // final flush
 
-                        // GET phase
-                        for (int i = 0; i < n; i++) {
-                            std::string val;
-                            store.get("k" + std::to_string(i), val);
-                        }
-
-                        auto end = std::chrono::steady_clock::now();
+                        // GET phase: uniform over the keys just written
+                        config.key_dist = KeyDistribution::RANDOM;
+                        config.put_ratio = 0.0;
+                        config.get_ratio = 1.0;
 
-                        double seconds =
-                            std::chrono::duration<double>(end - start).count();
+                        RunResult reads = BenchmarkRunner(store, config, options).run();
 
                         std::cout << "Benchmark completed\n";
-                        std::cout << "Operations: " << (n * 2) << "\n";
-                        std::cout << "Time: " << seconds << " sec\n";
-                        std::cout << "Throughput: "
-                                  << (n * 2) / seconds
-                                  << " ops/sec\n";
+                        std::cout << "-- PUT phase --\n";
+                        writes.print(std::cout);
+                        std::cout << "-- GET phase --\n";
+                        reads.print(std::cout);
                     }
 
                     else {